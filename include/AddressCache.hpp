@@ -0,0 +1,51 @@
+#ifndef ADDRESS_CACHE_HPP
+#define ADDRESS_CACHE_HPP
+
+#include <SFML/Network.hpp>
+#include <mutex>
+#include <chrono>
+#include <future>
+#include <optional>
+#include <unordered_map>
+
+/**
+ * @class AddressCache
+ *
+ * @brief Resolved host addresses shared by FTP, telnet and pooled sessions.
+ *
+ * A hostname is resolved at most once per TTL; when several connections resolve the same
+ * hostname at once, only the first one asks DNS and the others wait for its result.
+ */
+class AddressCache{
+public:
+    static AddressCache& instance();
+
+    /**
+     * @return Address of the host or std::nullopt if it can't be resolved
+     */
+    std::optional<sf::IpAddress> resolve(const std::string& hostname);
+
+    /**
+     * @brief Uses already known address (e.g. from cached host facts) for the hostname
+     */
+    void seed(const std::string& hostname, const sf::IpAddress& address);
+
+    /**
+     * @brief Drops the address, so it is resolved again (e.g. after failed connection)
+     */
+    void forget(const std::string& hostname);
+    void setTtl(const std::chrono::seconds& ttl);
+private:
+    struct Entry{
+        std::shared_future<std::optional<sf::IpAddress>> m_address;
+        std::chrono::steady_clock::time_point m_resolved;
+    };
+
+    AddressCache();
+
+    std::unordered_map<std::string, Entry> m_entries;
+    std::chrono::seconds m_ttl;
+    std::mutex m_mutex;
+};
+
+#endif
@@ -4,7 +4,18 @@
 #include "PathMonitor.hpp"
 #include "Configuration.hpp"
 #include "TelnetClient.hpp"
+#include "TelnetSessionPool.hpp"
+#include "HostFactsCache.hpp"
+#include "RebuildPlanner.hpp"
+#include "BuildHistory.hpp"
+#include "Checksum.hpp"
+#include "RemotePrefetcher.hpp"
+#include "RemoteFileCache.hpp"
+#include "TransferManifest.hpp"
+#include "LineEndings.hpp"
+#include "LocalFileReader.hpp"
 #include <SFML/Network.hpp>
+#include <future>
 
 class Observer{
 public:
@@ -30,27 +41,273 @@ private:
     std::list<Observer*> m_observers;
 };
 
+/**
+ * @struct HostTransferResult
+ * @brief Outcome of sending a changeset to one of several hosts
+ */
+struct HostTransferResult{
+    std::string m_alias;
+    std::size_t m_transferred = 0;
+    std::vector<std::string> m_errors;
+    std::chrono::milliseconds m_elapsed{0};
+};
+
+/**
+ * @struct RestartResult
+ * @brief Outcome and timings of restarting one target
+ */
+struct RestartResult{
+    std::string m_target;
+    std::string m_error;
+    std::chrono::milliseconds m_shutdown{0};
+    std::chrono::milliseconds m_boot{0};
+    std::chrono::milliseconds m_ready{0};
+};
+
+/**
+ * @struct DirectoryBuildResult
+ * @brief Outcome of building one remote directory
+ */
+struct DirectoryBuildResult{
+    std::filesystem::path m_directory;
+    bool m_built = false;
+    std::string m_error;
+    std::chrono::milliseconds m_elapsed{0};
+    std::vector<std::string> m_summary;
+};
+
 class AppModel : public Subject {
     friend class AppCLIFeatures;
 public:
     AppModel();
+    ~AppModel();
 
-    bool connectToFtp(const HostData& host);
-    bool connectToTelnet(const HostData& host);
+    bool connectToFtp(const HostData& host, const bool& suppressOutput = false);
+    bool connectToTelnet(const HostData& host, const bool& suppressOutput = false);
     bool isConnectedToFtp();
+    /**
+     * @brief Starts connecting FTP and telnet (login and initial script) to the host concurrently, in background
+     * 
+     * Connections already up are left alone. Nothing is reported, ensureFtp and ensureTelnet wait
+     * for the result and report errors, so FTP and telnet must not be used before calling them.
+     * 
+     * @param telnet If false, only FTP is warmed up
+     */
+    void warmup(const HostData& host, const bool& telnet = true);
+    /**
+     * @brief Waits for FTP warmup or connects FTP if it is not connected
+     * 
+     * @return true if FTP is connected
+     */
+    bool ensureFtp(const HostData& host);
+    /**
+     * @brief Waits for telnet warmup or connects telnet if it is not connected
+     * 
+     * @return true if telnet is connected and initial script was executed
+     */
+    bool ensureTelnet(const HostData& host);
+    /**
+     * @brief Closes FTP and telnet connections, including those being warmed up
+     */
+    void disconnect();
     Configuration& config() { return m_configuration; }
     PathMonitor& monitor() { return m_monitor; }
     TelnetClient& telnet() { return m_telnet; }
+    TelnetSessionPool& telnetPool() { return m_telnetPool; }
+    HostFactsCache& facts() { return m_facts; }
+    RemoteFileCache& cache() { return m_cache; }
+    /**
+     * @brief Directories with makefile touched by the last transfer
+     */
+    const RebuildPlanner& touchedDirectories() const { return m_rebuild; }
+    /**
+     * @brief Path to remote sources of current host, from live telnet session or from cached host facts
+     * 
+     * @return Path or empty string if it is not known yet
+     */
+    std::string remoteSource();
 
     bool listChangedFiles();
     std::pair<bool, std::string> tlog(const std::string& filename);
+    /**
+     * @brief Streams tlog output over a dedicated telnet session straight into a local file
+     * 
+     * No file is created on the remote host. Without duration and size limit, capture stops on enter.
+     * 
+     * @param filename Name of the local file created in temp directory
+     * @param filter If set, only lines passing the filter are saved
+     * @param duration Capture stops after that time, zero for no limit
+     * @param maxBytes Capture stops after that many bytes were saved, zero for no limit
+     * 
+     * @return First value is true if succedeed, and second one is path of the local file
+     */
+    std::pair<bool, std::string> tlogStream(const std::string& filename, const std::shared_ptr<OutputFilter>& filter = nullptr,
+                                            const std::chrono::seconds& duration = std::chrono::seconds(0), const std::size_t& maxBytes = 0);
+    /**
+     * @brief Restarts comma separated targets, independent ones in parallel over pooled telnet sessions
+     * 
+     * Target may list targets it waits for after colons (see RestartPlan). After boot, tmadmin psr
+     * is polled until the target's servers are up, so dependents start only once it is ready.
+     * 
+     * @return true if all targets are up
+     */
     bool restart(const std::string& arg);
-    bool script(const std::string& script);
+    /**
+     * @brief Executes script keeping only the tail of its output in memory
+     * 
+     * @param script Command to be executed
+     * @param outputLog If not empty, whole output is streamed to that file
+     * @param filter If set, only lines passing the filter are printed
+     */
+    bool script(const std::string& script, const std::string& outputLog = "", const std::shared_ptr<OutputFilter>& filter = nullptr);
+    /**
+     * @brief Creates filter from rules described in OutputFilter
+     * 
+     * @return Filter or nullptr if there are no rules or some rule is invalid
+     */
+    std::shared_ptr<OutputFilter> makeOutputFilter(const std::vector<std::string>& rules, const std::size_t& context = 0);
     bool transfer(const std::string& arg, const bool& useDifftool);
+    /**
+     * @brief Sends the same changeset to several hosts concurrently
+     * 
+     * Changes are computed once. Each host gets its own FTP session (and pooled telnet session when
+     * its source path is not known), files are overwritten without difftool. Results are reported per host.
+     * 
+     * @param arg Which changes to send: added, deleted, updated or all
+     * @param aliases Hosts to send to
+     * 
+     * @return true if all files were sent to all hosts
+     */
+    bool transfer(const std::string& arg, const std::vector<std::string>& aliases);
+    /**
+     * @brief Builds only the directories touched by the last transfer, over pooled telnet sessions
+     * 
+     * Directories not containing each other are built in parallel, a directory is built after
+     * the directories below it. Build stops at the first level which failed.
+     * 
+     * @param command Build command executed in each directory
+     * 
+     * @return true if all directories were built
+     */
+    bool rebuild(const std::string& command = "make");
+    /**
+     * @brief Sends changes between base and HEAD as one patch, applied on remote host over telnet
+     * 
+     * Patch made by `git diff --binary` is applied by `git apply`, or by `patch` where git is missing.
+     * Checksums of remote files then show which files were not patched to their local content;
+     * those are uploaded whole and deleted files still present are deleted via FTP.
+     * Files are not compared in difftool.
+     * 
+     * @param base Branch or commit the changes are compared with, as in --transfer-branch
+     * 
+     * @return true if all files match local ones in the end
+     */
+    bool transferPatch(const std::string& base);
+    /**
+     * @brief Transfers files and builds their directories in one pipeline
+     * 
+     * Files are sent grouped by the directory which builds them, directories with the longest
+     * previous builds first. Once all files of a directory (and builds of directories below it) are done,
+     * its build starts over a pooled telnet session while the remaining files are being sent.
+     * 
+     * @param arg Which changes to send: added, deleted, updated or all
+     * @param command Build command executed in each directory
+     * 
+     * @return true if all files were sent and all directories were built
+     */
+    bool transferAndBuild(const std::string& arg, const bool& useDifftool, const std::string& command = "make");
+    /**
+     * @brief Checks files uploaded by the last transfer against their remote copies without downloading them
+     * 
+     * Remote checksums of all files are computed by one `cksum` command over telnet, local ones in parallel
+     * meanwhile. Mismatched files are sent again and checked again. Files edited in difftool are not checked,
+     * as their remote content differs from the local file on purpose.
+     * 
+     * @return true if all files match
+     */
+    bool verify();
+    /**
+     * @brief Reports for every file whether its remote copy equals local one, equals the last push or has diverged
+     * 
+     * Remote checksums come from one `cksum` command over telnet, local ones are computed in parallel meanwhile.
+     * Diverged remote copies are downloaded in background and their differences from local files are printed
+     * as unified diffs.
+     * 
+     * @param scope `changed` for updated files of the current changeset, `all` for every file in local path
+     * 
+     * @return true if the report was made
+     */
+    bool drift(const std::string& scope);
+    /**
+     * @brief Downloads files which differ on remote host (e.g. hotfixes made there) straight into local path
+     * 
+     * Checksums of all remote files, except hidden ones, come from one `cksum` command over telnet and are
+     * compared with local ones computed in parallel. Differing files are downloaded over separate FTP sessions.
+     * 
+     * Files missing locally are offered only when git wouldn't ignore them and they weren't deleted
+     * locally since the last push.
+     * 
+     * @param confirm Called with a question and the files it concerns, once for files missing locally
+     *                and once for existing local files which would be overwritten; files it rejects are skipped
+     * 
+     * @return true if all selected files were downloaded
+     */
+    bool pull(const std::function<bool(const std::string&, const std::vector<std::filesystem::path>&)>& confirm);
+    /**
+     * @brief Starts downloading remote versions of the files in background, over separate FTP sessions
+     * 
+     * Updating a prefetched file then uses the downloaded copy instead of downloading it again.
+     * 
+     * @param files Files relative to local path
+     */
+    void prefetch(const std::vector<std::filesystem::path>& files);
+    /**
+     * @brief Stops prefetching and deletes prefetched copies
+     */
+    void stopPrefetch();
+    /**
+     * @brief Unmaps local files read during the last operations, so other programs may change them freely
+     */
+    void releaseLocalFiles();
 
 private:
     bool changeFTPDirectory(const std::filesystem::path& path);
+    /**
+     * @brief Records outcome of FTP command, so liveness is known without probing the server
+     */
+    sf::Ftp::Response track(const sf::Ftp::Response& response);
+    /**
+     * @brief Runs FTP commands of one file again on fresh connection, if they failed because connection was lost
+     * 
+     * @return true if commands succeeded
+     */
+    bool ftpRetry(const std::function<bool()>& commands);
     bool transferFile(const std::filesystem::path& file, const std::filesystem::path& to, const bool& suppressOutput = false);
+    /**
+     * @brief Uploads file in chunks over several FTP sessions in parallel, joins them on remote host and checks the result
+     * 
+     * Sessions run on the shared TaskExecutor and are waited for, so this must not be called from a task
+     * of that executor (e.g. from transferToHost), it would deadlock once all workers wait.
+     * 
+     * @param remote Remote path of the joined file
+     * 
+     * @return true if the joined file has the same checksum as the local one and replaced the remote file
+     */
+    bool uploadChunked(const std::filesystem::path& file, const std::filesystem::path& remote);
+    bool isChunked(const std::filesystem::path& file) const;
+    /**
+     * @brief Text files with CR bytes are sent as their LF copy, everything else as it is
+     * 
+     * @return File to upload in binary mode; if it isn't the file itself, discard removes it after upload
+     */
+    std::filesystem::path sendable(const std::filesystem::path& file);
+    void discard(const std::filesystem::path& sent, const std::filesystem::path& file);
+    /**
+     * @brief Gives downloaded text file native line endings
+     */
+    void localize(const std::filesystem::path& file) const;
+    std::optional<FileChecksum> localChecksum(const std::filesystem::path& file);
+    FileKind localKind(const std::filesystem::path& file);
     std::filesystem::path getRemoteFileEquivalent(const std::filesystem::path& file);
     std::pair<bool, std::string> uploadAddedFile(const std::filesystem::path& file, const bool& suppressOutput = false);
     std::pair<bool, std::string> updateRemoteFile(const std::filesystem::path& file, const bool& useDifftool, const bool& suppressOutput = false);
@@ -66,11 +323,46 @@ private:
     std::pair<bool, std::string> downloadRemoteFile(const std::filesystem::path& file, const bool& suppressOutput = false);
 
     bool difftool(const std::string& first, const std::string& second);
+    /**
+     * @brief Merges local changes into downloaded remote copy, using content last pushed to the host as base
+     * 
+     * @return true if merge was clean and remote copy now holds the result; false if there is no base or changes conflict
+     */
+    bool mergeWithBase(const std::filesystem::path& remote, const std::string& local, const std::string& remoteCopy, const bool& suppressOutput);
+    static std::vector<std::string> restartCommands(const std::string& target);
+    std::shared_ptr<OutputCapture> makeCapture();
+    std::optional<sf::IpAddress> resolve(const HostData& host);
+    void forgetAddress(const HostData& host);
+    bool prepareTransfer(const HostData& host);
+    std::optional<std::map<std::string, FileChecksum>> remoteChecksums(const HostData& host, const std::vector<std::filesystem::path>& files);
+    /**
+     * @return Files of LOCAL_PATH which git doesn't ignore, all of them when git can't tell
+     */
+    std::vector<std::filesystem::path> notIgnored(const std::vector<std::filesystem::path>& files) const;
+    DirectoryBuildResult buildDirectory(const HostData& host, const std::filesystem::path& directory, const std::string& command);
+    RestartResult restartTarget(const HostData& host, const std::string& target);
+    HostTransferResult transferToHost(const HostData& host, const std::vector<std::filesystem::path>& upload,
+                                      const std::vector<std::filesystem::path>& remove);
 
     Configuration m_configuration;
     PathMonitor m_monitor;
     TelnetClient m_telnet;
+    TelnetSessionPool m_telnetPool;
+    HostFactsCache m_facts;
+    RemoteFileCache m_cache;
+    TransferManifest m_manifest;
+    RebuildPlanner m_rebuild;
+    BuildHistory m_buildHistory;
+    std::vector<std::filesystem::path> m_uploaded;
+    RemotePrefetcher m_prefetcher;
+    uint64_t m_chunkThreshold;
+    LineEndings m_lineEndings;
+    LocalFileReader m_localFiles;
+    std::future<bool> m_ftpWarmup;
+    std::future<bool> m_telnetWarmup;
     sf::Ftp m_ftp;
+    bool m_ftpAlive;
+    std::chrono::steady_clock::time_point m_ftpLastReply;
     std::string m_workingDir;
 };
 
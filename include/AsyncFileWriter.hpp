@@ -0,0 +1,55 @@
+#ifndef ASYNC_FILE_WRITER_HPP
+#define ASYNC_FILE_WRITER_HPP
+
+#include <string>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <filesystem>
+#include <condition_variable>
+
+/**
+ * @class AsyncFileWriter
+ *
+ * @brief Buffers written data and stores it to a file on a background thread.
+ *
+ * Data is collected in one buffer while the other one is being written, so the producer
+ * (usually a socket reading loop) never waits for the disk. Buffered data is written
+ * whenever the buffer fills up and at least every half a second.
+ */
+class AsyncFileWriter{
+public:
+    AsyncFileWriter(const std::size_t& bufferSize = 256 * 1024);
+    ~AsyncFileWriter();
+
+    /**
+     * @brief Opens (truncates) the file and starts the writing thread.
+     *
+     * @return true if the file was opened; false otherwise.
+     */
+    bool open(const std::filesystem::path& path);
+    void write(const char* data, const std::size_t& size);
+    void write(const std::string& data) {write(data.data(), data.size());}
+
+    /**
+     * @brief Writes everything buffered so far, stops the thread and closes the file.
+     */
+    void close();
+    bool isOpen() const {return m_thread.joinable();}
+    std::size_t bytesWritten() const {return m_written;}
+private:
+    void run();
+
+    std::ofstream m_file;
+    std::string m_front;
+    std::string m_back;
+    const std::size_t m_bufferSize;
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::thread m_thread;
+    bool m_closing;
+    std::atomic<std::size_t> m_written;
+};
+
+#endif
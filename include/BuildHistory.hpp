@@ -0,0 +1,48 @@
+#ifndef BUILD_HISTORY_HPP
+#define BUILD_HISTORY_HPP
+
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <optional>
+#include <filesystem>
+
+/**
+ * @class BuildHistory
+ *
+ * @brief Remembers how long builds of remote directories took, so the longest ones can be started first.
+ *
+ * Times are kept per host alias and directory (relative to remote sources) in a file, one
+ * `alias milliseconds directory` line each. A new time is averaged with the stored one.
+ */
+class BuildHistory{
+public:
+    /**
+     * @param path File the times are kept in, read immediately
+     */
+    BuildHistory(const std::string& path);
+
+    std::optional<std::chrono::milliseconds> estimate(const std::string& alias, const std::filesystem::path& directory) const;
+
+    /**
+     * @brief Stores build time of the directory and saves the file
+     */
+    void record(const std::string& alias, const std::filesystem::path& directory, const std::chrono::milliseconds& elapsed);
+
+    /**
+     * @brief Orders directories by expected build time, longest first
+     *
+     * Directories never built are expected to take the average of the known ones.
+     */
+    std::vector<std::filesystem::path> longestFirst(const std::string& alias, std::vector<std::filesystem::path> directories) const;
+    bool readFile();
+    bool saveFile();
+private:
+    std::map<std::pair<std::string, std::string>, std::chrono::milliseconds> m_times;
+    const std::string m_path;
+    mutable std::mutex m_mutex;
+};
+
+#endif
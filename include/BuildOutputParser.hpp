@@ -0,0 +1,91 @@
+#ifndef BUILD_OUTPUT_PARSER_HPP
+#define BUILD_OUTPUT_PARSER_HPP
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+
+/**
+ * @struct BuildDiagnostic
+ * @brief Compiler or linker message found in build output
+ */
+struct BuildDiagnostic{
+    std::string m_file;
+    int m_line = 0;
+    bool m_error = true;
+    bool m_linker = false;
+    std::string m_message;
+    std::string m_target;
+};
+
+/**
+ * @struct BuildTarget
+ * @brief Target built by make together with time spent on it
+ */
+struct BuildTarget{
+    std::string m_name;
+    std::chrono::milliseconds m_elapsed;
+};
+
+/**
+ * @class BuildOutputParser
+ *
+ * @brief Incrementally recognises make targets, compiler diagnostics and linker failures.
+ *
+ * Output is fed line by line as it arrives, so nothing but the found diagnostics is kept.
+ * Recognised formats are `making target NAME`, gcc/clang `file:line[:col]: error|warning: msg`,
+ * xlc `"file", line N.C: code (S|E|W) msg` and ld/collect2 failures.
+ */
+class BuildOutputParser{
+public:
+    using Clock = std::chrono::steady_clock;
+    using ProgressCallback = std::function<void(const BuildOutputParser&)>;
+
+    BuildOutputParser();
+
+    void parseLine(const std::string& line);
+
+    /**
+     * @brief Closes the timing of the last target.
+     */
+    void finish();
+    void setProgressCallback(const ProgressCallback& callback) {m_progressCallback = callback;}
+
+    const std::vector<BuildTarget>& targets() const {return m_targets;}
+    const std::vector<BuildDiagnostic>& diagnostics() const {return m_diagnostics;}
+    const std::string& currentTarget() const {return m_current;}
+    std::size_t errors() const {return m_errors;}
+    std::size_t warnings() const {return m_warnings;}
+    bool empty() const {return m_targets.empty() && m_current.empty() && m_diagnostics.empty();}
+
+    /**
+     * @brief One line with the current counters
+     */
+    std::string progress() const;
+
+    /**
+     * @brief Summary lines: targets with elapsed time, then errors and warnings with file and line
+     *
+     * @param maxDiagnostics Maximum number of diagnostics listed
+     */
+    std::vector<std::string> summary(const std::size_t& maxDiagnostics = 20) const;
+private:
+    void startTarget(const std::string& name);
+    void closeTarget(const Clock::time_point& now);
+    bool parseLinker(const std::string& line);
+    bool parseGcc(const std::string& line);
+    bool parseXlc(const std::string& line);
+    void addDiagnostic(BuildDiagnostic diagnostic);
+
+    std::vector<BuildTarget> m_targets;
+    std::vector<BuildDiagnostic> m_diagnostics;
+    std::string m_current;
+    Clock::time_point m_currentStart;
+    Clock::time_point m_start;
+    std::size_t m_errors;
+    std::size_t m_warnings;
+    ProgressCallback m_progressCallback;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef CHECKSUM_HPP
+#define CHECKSUM_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <optional>
+#include <filesystem>
+
+/**
+ * @struct FileChecksum
+ * @brief POSIX cksum of a file: CRC and size in bytes
+ */
+struct FileChecksum{
+    uint32_t m_crc = 0;
+    uint64_t m_size = 0;
+    bool operator==(const FileChecksum& other) const {return m_crc == other.m_crc && m_size == other.m_size;}
+    bool operator!=(const FileChecksum& other) const {return !(*this == other);}
+};
+
+/**
+ * @class Checksum
+ *
+ * @brief Computes the same CRC as POSIX `cksum`, which is available on every remote host.
+ *
+ * Data can be fed in chunks. When CRLF is normalized, the checksum matches the file as it
+ * ends up on a UNIX host after ASCII mode FTP transfer.
+ */
+class Checksum{
+public:
+    Checksum(const bool& normalizeCrlf = false);
+
+    void update(const char* data, const std::size_t& size);
+    FileChecksum finish();
+
+    /**
+     * @return Checksum of the file or std::nullopt if it can't be read
+     */
+    static std::optional<FileChecksum> ofFile(const std::filesystem::path& path, const bool& normalizeCrlf = false);
+    static FileChecksum ofData(std::string_view data, const bool& normalizeCrlf = false);
+
+    /**
+     * @brief Reads `cksum` output lines: CRC, size and path, which is the rest of the line
+     *
+     * @return Checksums by path, lines which are not cksum results (errors, prompt) are skipped
+     */
+    static std::map<std::string, FileChecksum> parseOutput(const std::string& output);
+private:
+    void crc(const char* data, const std::size_t& size);
+
+    uint32_t m_crc;
+    uint64_t m_size;
+    const bool m_normalizeCrlf;
+    bool m_pendingCr;
+};
+
+#endif
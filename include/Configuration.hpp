@@ -5,6 +5,8 @@
 #include <map>
 #include <unordered_map>
 #include <filesystem>
+#include <optional>
+#include <vector>
 
 /**
  * @enum ConfigKey
@@ -19,6 +21,12 @@ enum class ConfigKey {
     LocalPath,       ///< Path to local sources which will be monitored for changes
     Difftool,        ///< Path to difftool used for comparing file differences
     DifftoolSide,    ///< Specify file which needs to be edited, LEFT or RIGHT (default is LEFT)
+    TelnetSessions,  ///< Maximum number of telnet sessions opened in parallel to one host (default is 4)
+    OutputTail,      ///< Size in KiB of the script output tail kept in memory (default is 64)
+    FactsTtl,        ///< Hours for which discovered host facts (source path, home, address) are reused, 0 disables (default is 24)
+    CacheSize,       ///< Size in MiB of the cache of downloaded remote files, 0 disables (default is 256)
+    ChunkThreshold,  ///< Size in MiB from which files are uploaded in chunks over several FTP sessions, 0 disables (default is 64)
+    BinaryFiles,     ///< Comma separated file name patterns of files sent without line ending conversion, other files are told by content
     None
 };
 
@@ -114,6 +122,24 @@ public:
     bool deleteHost(const std::string& host);
     bool addHost(const HostData& data);
     const HostData& getCurrentHost() const;
+    std::optional<HostData> getHost(const std::string& alias) const;
+
+    /**
+     * @brief Adds group of hosts, which can be used instead of listing the hosts one by one
+     * 
+     * Groups are saved as lines 'GROUP: name alias1,alias2,...'.
+     * 
+     * @return true if group was added; false if such group or host already exists or some host is unknown
+     */
+    bool addGroup(const std::string& name, const std::vector<std::string>& hosts);
+    std::vector<std::string> getGroup(const std::string& name) const;
+
+    /**
+     * @brief Expands comma separated host aliases and group names into host aliases
+     * 
+     * @return Aliases in order of first appearance without duplicates; empty if some name is neither host nor group
+     */
+    std::vector<std::string> expandHosts(const std::string& names) const;
 private:
     void setDefaultValues();
     static std::string keyToString(const ConfigKey& key);
@@ -123,6 +149,7 @@ private:
 
     std::map<ConfigKey, std::string> m_configData;
     std::unordered_map<std::string, HostData> m_hosts;
+    std::map<std::string, std::vector<std::string>> m_groups;
     const std::string m_configFile;
     bool m_save;
 };
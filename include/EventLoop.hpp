@@ -0,0 +1,69 @@
+#ifndef EVENT_LOOP_HPP
+#define EVENT_LOOP_HPP
+
+#include <SFML/Network.hpp>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+/**
+ * @class EventLoop
+ *
+ * @brief Single thread waiting on every registered socket at once.
+ *
+ * Sockets are registered with a handler called when data is ready and a handler called
+ * on every loop iteration (at least every 20 ms), used for timeouts. No matter how many
+ * sessions or commands are in flight, they are all served by this one thread.
+ */
+class EventLoop{
+public:
+    using Handler = std::function<void()>;
+
+    static EventLoop& instance();
+    ~EventLoop();
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * @brief Registers connected socket, handlers are called from the loop thread only
+     *
+     * @return Id used to remove the socket
+     */
+    std::size_t add(sf::Socket& socket, const Handler& onReadable, const Handler& onTick);
+
+    /**
+     * @brief Unregisters socket
+     *
+     * When called outside of the loop thread, waits until handlers of the socket can't be running anymore.
+     */
+    void remove(const std::size_t& id);
+    bool isLoopThread() const {return std::this_thread::get_id() == m_thread.get_id();}
+private:
+    struct Entry{
+        sf::Socket* m_socket;
+        Handler m_onReadable;
+        Handler m_onTick;
+    };
+
+    EventLoop();
+    void run();
+    void applyChanges();
+
+    std::map<std::size_t, Entry> m_entries;
+    std::vector<std::pair<std::size_t, Entry>> m_added;
+    std::vector<std::size_t> m_removed;
+    sf::SocketSelector m_selector;
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::size_t m_nextId;
+    std::size_t m_requested;
+    std::size_t m_applied;
+    bool m_running;
+    std::thread m_thread;
+};
+
+#endif
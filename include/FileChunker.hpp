@@ -0,0 +1,35 @@
+#ifndef FILE_CHUNKER_HPP
+#define FILE_CHUNKER_HPP
+
+#include <vector>
+#include <cstdint>
+#include <string_view>
+#include <filesystem>
+
+/**
+ * @class FileChunker
+ *
+ * @brief Splits a file into chunk files, which joined in order give the original file.
+ *
+ * Chunks end after a newline where there is one near the requested size, so a chunk of
+ * a text file holds whole lines.
+ */
+class FileChunker{
+public:
+    /**
+     * @param chunkSize Requested size of one chunk in bytes, chunks may be longer up to the next newline
+     *
+     * @return Chunk files `<filename>.partNNN` in the directory, in order; empty if the file can't be split
+     */
+    static std::vector<std::filesystem::path> split(const std::filesystem::path& file, const std::filesystem::path& directory,
+                                                    const uint64_t& chunkSize);
+    /**
+     * @brief Splits content already in memory, e.g. a mapped file, into the same chunks as the file holding it
+     *
+     * @param name File name the chunks are named after
+     */
+    static std::vector<std::filesystem::path> split(std::string_view content, const std::string& name, const std::filesystem::path& directory,
+                                                    const uint64_t& chunkSize);
+};
+
+#endif
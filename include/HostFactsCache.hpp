@@ -0,0 +1,72 @@
+#ifndef HOST_FACTS_CACHE_HPP
+#define HOST_FACTS_CACHE_HPP
+
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <optional>
+#include "Configuration.hpp"
+
+/**
+ * @struct HostFacts
+ * @brief Facts about a host discovered over telnet, which don't change between sessions
+ */
+struct HostFacts{
+    std::string m_source;   ///< Path to remote sources, printed by the initial script (zrodla: ...)
+    std::string m_home;     ///< Working directory right after the initial script
+    std::string m_prompt;   ///< Shell prompt as it looked right after the initial script
+    std::string m_ip;       ///< Resolved address of the host
+    std::chrono::system_clock::time_point m_updated;
+};
+
+/**
+ * @class HostFactsCache
+ *
+ * @brief Keeps discovered host facts in a file, so they don't have to be discovered on every start.
+ *
+ * Facts are stored per host alias together with the hostname, username and initial script they
+ * were discovered with. They are given out only while younger than TTL and while those settings
+ * still match the host configuration.
+ */
+class HostFactsCache{
+public:
+    /**
+     * @param path File the facts are kept in, read immediately
+     * @param ttl Facts older than that are ignored, zero disables the cache
+     */
+    HostFactsCache(const std::string& path, const std::chrono::hours& ttl = std::chrono::hours(24));
+
+    /**
+     * @brief Returns facts of the host if they are fresh and were discovered with its current settings
+     */
+    std::optional<HostFacts> get(const HostData& host) const;
+
+    /**
+     * @brief Stores facts of the host and saves the file
+     *
+     * Facts which are empty are taken over from already stored ones.
+     */
+    void store(const HostData& host, const HostFacts& facts);
+    void invalidate(const std::string& alias);
+    void setTtl(const std::chrono::hours& ttl);
+
+    bool readFile();
+    bool saveFile();
+private:
+    struct Entry{
+        std::string m_hostname;
+        std::string m_username;
+        std::string m_script;
+        HostFacts m_facts;
+    };
+
+    bool isValid(const Entry& entry, const HostData& host) const;
+
+    std::map<std::string, Entry> m_entries;
+    const std::string m_path;
+    std::chrono::hours m_ttl;
+    mutable std::mutex m_mutex;
+};
+
+#endif
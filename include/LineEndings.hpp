@@ -0,0 +1,63 @@
+#ifndef LINE_ENDINGS_HPP
+#define LINE_ENDINGS_HPP
+
+#include <string>
+#include <vector>
+#include <string_view>
+#include <filesystem>
+
+/**
+ * @enum FileKind
+ * @brief How a file is transferred: text has its line endings converted, binary is sent byte for byte
+ */
+enum class FileKind {
+    Text,
+    Binary
+};
+
+/**
+ * @class LineEndings
+ *
+ * @brief Decides which files are text and converts their line endings locally.
+ *
+ * Files are transferred in binary mode, so the FTP server never rewrites them; text files are
+ * sent with LF line endings and downloaded ones get the native line endings. A file is binary
+ * when its name matches one of the patterns, otherwise when its first block contains a NUL byte,
+ * as git decides. Scanning relies on memchr and memcpy, which the C library vectorizes.
+ */
+class LineEndings{
+public:
+    /**
+     * @param binaryPatterns Comma separated file name patterns with `*` and `?` wildcards, e.g. `*.so,*.pdf`
+     */
+    LineEndings(const std::string& binaryPatterns = "");
+
+    FileKind kind(const std::filesystem::path& file) const;
+    /**
+     * @brief Same as kind(file), for a file whose content is already in memory
+     */
+    FileKind kind(const std::filesystem::path& file, std::string_view content) const;
+    static bool isBinary(const char* data, const std::size_t& size);
+    static bool matches(const std::string& pattern, const std::string& name);
+
+    /**
+     * @brief Copies the file with CRLF line endings turned into LF, or LF into CRLF
+     *
+     * @return true if the destination was written
+     */
+    static bool convert(const std::filesystem::path& from, const std::filesystem::path& to, const bool& crlf);
+    static bool convertContent(std::string_view content, const std::filesystem::path& to, const bool& crlf);
+
+    /**
+     * @return true if the file contains a CR byte, so sending it as LF text needs conversion
+     */
+    static bool hasCr(const std::filesystem::path& file);
+    static std::string toLf(std::string_view text);
+    static std::string toCrlf(std::string_view text);
+private:
+    bool matchesPattern(const std::filesystem::path& file) const;
+
+    std::vector<std::string> m_binaryPatterns;
+};
+
+#endif
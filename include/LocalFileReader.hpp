@@ -0,0 +1,81 @@
+#ifndef LOCAL_FILE_READER_HPP
+#define LOCAL_FILE_READER_HPP
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+#include <string_view>
+#include <filesystem>
+
+/**
+ * @class MappedFile
+ *
+ * @brief Read-only memory mapping of a whole local file, unmapped on destruction.
+ */
+class MappedFile{
+public:
+    MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @return true if the file was mapped (empty file is valid too)
+     */
+    bool isValid() const {return m_valid;}
+    std::string_view view() const {return std::string_view(m_data, m_size);}
+private:
+    const char* m_data;
+    std::size_t m_size;
+    bool m_valid;
+#ifdef _WIN32
+    void* m_mapping;
+#endif
+};
+
+/**
+ * @class LocalFileReader
+ *
+ * @brief Maps every local file once and shares the read-only view among all stages of a sync.
+ *
+ * Hashing, line ending detection, conversion, merging and diffing look at the same mapping,
+ * so a file is read from disk once however many stages use it. A mapping is reused while the
+ * file keeps its size and modification time. Files larger than the limit, or which can't be
+ * mapped, are not mapped at all and the callers stream them from disk instead.
+ */
+class LocalFileReader{
+public:
+    /**
+     * @param limit Largest file in bytes which is mapped
+     */
+    LocalFileReader(const uint64_t& limit = 1024ull * 1024 * 1024);
+
+    /**
+     * @return View of the file or nullptr if it has to be streamed
+     */
+    std::shared_ptr<const MappedFile> open(const std::filesystem::path& file);
+
+    /**
+     * @brief Drops all mappings, views already handed out stay valid until released
+     */
+    void clear();
+    /**
+     * @brief Drops mapping of one file, e.g. of a temporary copy which is about to be deleted
+     */
+    void release(const std::filesystem::path& file);
+    std::size_t mappings() const;
+private:
+    struct Entry{
+        std::shared_ptr<const MappedFile> m_file;
+        uint64_t m_size = 0;
+        std::filesystem::file_time_type m_modified;
+    };
+
+    const uint64_t m_limit;
+    std::map<std::filesystem::path, Entry> m_entries;
+    std::size_t m_mappings;
+    mutable std::mutex m_mutex;
+};
+
+#endif
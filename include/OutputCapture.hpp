@@ -0,0 +1,65 @@
+#ifndef OUTPUT_CAPTURE_HPP
+#define OUTPUT_CAPTURE_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <functional>
+#include <filesystem>
+
+/**
+ * @class OutputCapture
+ *
+ * @brief Captures output of long running commands in constant memory.
+ *
+ * Only the last bytes of the output are kept in a fixed size ring buffer, together with
+ * the first error-looking lines. Everything else can be streamed to a file sink and/or
+ * passed line by line to a callback as it arrives.
+ */
+class OutputCapture{
+public:
+    using LineCallback = std::function<void(const std::string&)>;
+
+    /**
+     * @param tailSize Number of last bytes kept in memory
+     * @param maxErrorLines Number of first error-looking lines kept in memory
+     */
+    OutputCapture(const std::size_t& tailSize = 64 * 1024, const std::size_t& maxErrorLines = 50);
+
+    /**
+     * @brief Streams the whole output to the file, file is truncated.
+     *
+     * @return true if the file was opened for writing; false otherwise.
+     */
+    bool setFileSink(const std::filesystem::path& path);
+    void setLineCallback(const LineCallback& callback) {m_lineCallback = callback;}
+
+    void append(const char* data, const std::size_t& size);
+    void append(const std::string& data) {append(data.data(), data.size());}
+
+    /**
+     * @brief Passes the last unterminated line to the consumers and flushes the file sink.
+     */
+    void finish();
+
+    std::string tail() const;
+    const std::vector<std::string>& errorLines() const {return m_errorLines;}
+    std::size_t totalBytes() const {return m_totalBytes;}
+
+    static bool isErrorLine(const std::string& line);
+private:
+    void writeTail(const char* data, std::size_t size);
+    void processLine();
+
+    std::vector<char> m_ring;
+    std::size_t m_head;
+    std::size_t m_filled;
+    std::size_t m_totalBytes;
+    std::string m_line;
+    std::vector<std::string> m_errorLines;
+    const std::size_t m_maxErrorLines;
+    std::ofstream m_file;
+    LineCallback m_lineCallback;
+};
+
+#endif
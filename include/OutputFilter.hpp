@@ -0,0 +1,75 @@
+#ifndef OUTPUT_FILTER_HPP
+#define OUTPUT_FILTER_HPP
+
+#include <regex>
+#include <string>
+#include <vector>
+#include <functional>
+
+/**
+ * @class OutputFilter
+ *
+ * @brief Line filter applied to streamed output as it is received.
+ *
+ * Rules are given as text:
+ * - `TEXT` keeps lines containing TEXT
+ * - `!TEXT` drops lines containing TEXT
+ * - `/REGEX/` keeps lines matching REGEX
+ * - `!/REGEX/` drops lines matching REGEX
+ *
+ * Without any keep rule every line not dropped is kept. Literal rules are searched over the
+ * whole received chunk at once with a vectorized search, so lines which can't match are
+ * skipped without looking at them one by one. Regular expressions are only used as a fallback.
+ * Kept lines can be surrounded by context lines, like grep -B/-A does.
+ */
+class OutputFilter{
+public:
+    using Sink = std::function<void(const char*, const std::size_t&)>;
+
+    OutputFilter(const Sink& sink = nullptr);
+
+    /**
+     * @brief Adds rule in the format described above
+     *
+     * @return true if the rule was added; false if it is empty or an invalid regular expression.
+     */
+    bool addRule(const std::string& rule);
+    void setContext(const std::size_t& before, const std::size_t& after);
+    void setSink(const Sink& sink) {m_sink = sink;}
+    bool empty() const {return m_include.empty() && m_exclude.empty() && m_includeRegex.empty() && m_excludeRegex.empty();}
+
+    void feed(const char* data, const std::size_t& size);
+    void feed(const std::string& data) {feed(data.data(), data.size());}
+
+    /**
+     * @brief Filters the last unterminated line.
+     */
+    void finish();
+
+    /**
+     * @brief Finds first occurrence of needle in [begin, end)
+     *
+     * @return Pointer to the occurrence or nullptr if there is none
+     */
+    static const char* findLiteral(const char* begin, const char* end, const std::string& needle);
+private:
+    void filterLines(const char* begin, const char* end);
+    void filterLine(const char* begin, const char* end, const bool& keywordFound);
+    bool keywordIn(const char* begin, const char* end) const;
+    bool excluded(const char* begin, const char* end) const;
+    void emit(const char* begin, const char* end);
+
+    Sink m_sink;
+    std::vector<std::string> m_include;
+    std::vector<std::string> m_exclude;
+    std::vector<std::regex> m_includeRegex;
+    std::vector<std::regex> m_excludeRegex;
+    std::string m_pending;
+    std::vector<std::string> m_before;
+    std::size_t m_beforeStart;
+    std::size_t m_beforeCount;
+    std::size_t m_afterContext;
+    std::size_t m_afterLeft;
+};
+
+#endif
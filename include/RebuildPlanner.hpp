@@ -0,0 +1,60 @@
+#ifndef REBUILD_PLANNER_HPP
+#define REBUILD_PLANNER_HPP
+
+#include <filesystem>
+#include <vector>
+#include <set>
+#include <map>
+#include <functional>
+#include <optional>
+
+/**
+ * @class RebuildPlanner
+ *
+ * @brief Finds directories which have to be rebuilt after some files changed.
+ *
+ * For every changed file the nearest directory with a makefile (looking up from the file towards
+ * the local root) is chosen, the local tree mirrors the remote one. Directories are ordered into
+ * waves, deepest first, so a directory is built only after the directories below it; directories
+ * of one wave don't contain each other and can be built in parallel.
+ */
+class RebuildPlanner{
+public:
+    RebuildPlanner(const std::filesystem::path& localRoot = "");
+
+    void setRoot(const std::filesystem::path& localRoot);
+    void clear();
+
+    /**
+     * @param file Changed file relative to the local root
+     *
+     * @return Directory which builds the file, std::nullopt if there is no makefile above it
+     */
+    std::optional<std::filesystem::path> add(const std::filesystem::path& file);
+
+    /**
+     * @return Directories to build relative to the root
+     */
+    const std::set<std::filesystem::path>& directories() const {return m_directories;}
+
+    /**
+     * @return Changed files without any makefile above them
+     */
+    const std::vector<std::filesystem::path>& unbuildable() const {return m_unbuildable;}
+    std::vector<std::vector<std::filesystem::path>> waves() const;
+    bool empty() const {return m_directories.empty();}
+
+    /**
+     * @return true if directory is a subdirectory of ancestor (root of sources is an empty path)
+     */
+    static bool isBelow(const std::filesystem::path& directory, const std::filesystem::path& ancestor);
+private:
+    bool hasMakefile(const std::filesystem::path& directory);
+
+    std::filesystem::path m_root;
+    std::set<std::filesystem::path> m_directories;
+    std::vector<std::filesystem::path> m_unbuildable;
+    std::map<std::filesystem::path, bool> m_makefiles;
+};
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef REMOTE_FILE_CACHE_HPP
+#define REMOTE_FILE_CACHE_HPP
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <cstdint>
+#include <filesystem>
+
+/**
+ * @struct RemoteStat
+ * @brief Size and modification time of a remote file, as reported by FTP SIZE and MDTM
+ */
+struct RemoteStat{
+    uint64_t m_size = 0;
+    std::string m_modified;
+    bool operator==(const RemoteStat& other) const {return m_size == other.m_size && m_modified == other.m_modified;}
+};
+
+/**
+ * @class RemoteFileCache
+ *
+ * @brief Bounded on-disk cache of downloaded remote files.
+ *
+ * Files are keyed by host alias and remote path, and are valid while the remote size and
+ * modification time stay the same. Contents are stored once per hash, however many remote files
+ * share them; least recently used files are evicted when contents exceed the size budget.
+ * Index is kept in `index.txt`, contents in `objects` subdirectory.
+ */
+class RemoteFileCache{
+public:
+    /**
+     * @param directory Where the cache lives, index is read immediately
+     * @param budget Maximum size of stored contents in bytes, zero disables the cache
+     */
+    RemoteFileCache(const std::filesystem::path& directory, const uint64_t& budget = 256ull * 1024 * 1024);
+
+    /**
+     * @brief Copies cached content of the remote file to destination, so the caller may edit or delete it
+     *
+     * @return true if the file was cached with the same size and modification time
+     */
+    bool copyTo(const std::string& alias, const std::filesystem::path& remote, const RemoteStat& stat, const std::filesystem::path& destination);
+
+    /**
+     * @brief Stores downloaded remote file, evicting least recently used ones if needed
+     */
+    bool put(const std::string& alias, const std::filesystem::path& remote, const RemoteStat& stat, const std::filesystem::path& file);
+    void setBudget(const uint64_t& budget);
+    /**
+     * @return false if the budget is zero, callers then needn't look up size and modification time at all
+     */
+    bool enabled() const;
+    uint64_t size() const;
+    std::size_t objects() const;
+    bool readIndex();
+    bool saveIndex();
+
+    /**
+     * @return 64 bit FNV-1a hash of the file content as hex string, empty if it can't be read
+     */
+    static std::string hashFile(const std::filesystem::path& file);
+private:
+    struct Entry{
+        RemoteStat m_stat;
+        std::string m_hash;
+        uint64_t m_lastUsed = 0;
+    };
+    using Key = std::pair<std::string, std::string>;
+
+    void evict();
+    void removeUnreferenced(const std::string& hash);
+    std::filesystem::path objectPath(const std::string& hash) const;
+    bool saveIndexLocked();
+
+    const std::filesystem::path m_directory;
+    uint64_t m_budget;
+    std::map<Key, Entry> m_entries;
+    std::map<std::string, uint64_t> m_objects;
+    uint64_t m_size;
+    uint64_t m_clock;
+    mutable std::mutex m_mutex;
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef REMOTE_PREFETCHER_HPP
+#define REMOTE_PREFETCHER_HPP
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <future>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <filesystem>
+#include <condition_variable>
+#include "TaskExecutor.hpp"
+
+/**
+ * @class RemotePrefetcher
+ *
+ * @brief Downloads remote files in background before they are needed.
+ *
+ * Files are fetched in the given order by a bounded number of workers running on the prefetcher's
+ * own task executor, so long downloads never hold workers of the shared one. Each worker has its
+ * own connection made by the fetch factory. A file asked for
+ * before its turn is moved to the front of the queue. Copies never taken are deleted on cancel.
+ */
+class RemotePrefetcher{
+public:
+    /**
+     * @brief Downloads remote file into local directory, returns true on success
+     */
+    using Fetch = std::function<bool(const std::filesystem::path& remote, const std::filesystem::path& localDirectory)>;
+    /**
+     * @brief Called once by every worker, so each of them fetches over its own connection
+     */
+    using FetchFactory = std::function<Fetch()>;
+
+    /**
+     * @param directory Where the copies are downloaded, each into its own subdirectory
+     * @param maxConcurrency Maximum number of files downloaded at once
+     */
+    RemotePrefetcher(const std::filesystem::path& directory, const std::size_t& maxConcurrency = 2);
+    ~RemotePrefetcher();
+    RemotePrefetcher(const RemotePrefetcher&) = delete;
+    RemotePrefetcher& operator=(const RemotePrefetcher&) = delete;
+
+    /**
+     * @brief Cancels previous prefetch and starts downloading the files
+     */
+    void start(const FetchFactory& factory, const std::vector<std::filesystem::path>& remoteFiles);
+
+    /**
+     * @brief Waits until the file is downloaded and hands it over, the copy is valid until cancel
+     *
+     * @return Path to local copy; std::nullopt if the file wasn't prefetched or its download failed
+     */
+    std::optional<std::filesystem::path> take(const std::filesystem::path& remote);
+
+    /**
+     * @brief Drops queued files, waits for running downloads and deletes all copies
+     */
+    void cancel();
+    std::size_t downloaded() const;
+private:
+    enum class State{Queued, Downloading, Done, Failed, Taken};
+    struct Entry{
+        State m_state = State::Queued;
+        std::filesystem::path m_local;
+    };
+
+    void work(const FetchFactory& factory);
+
+    const std::filesystem::path m_directory;
+    const std::size_t m_maxConcurrency;
+    std::map<std::filesystem::path, Entry> m_entries;
+    std::deque<std::filesystem::path> m_queue;
+    std::vector<std::future<void>> m_workers;
+    std::size_t m_counter;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;
+    TaskExecutor m_executor;
+};
+
+#endif
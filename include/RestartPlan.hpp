@@ -0,0 +1,48 @@
+#ifndef RESTART_PLAN_HPP
+#define RESTART_PLAN_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+/**
+ * @class RestartPlan
+ *
+ * @brief Orders restart targets by declared dependencies.
+ *
+ * Targets are comma separated, each may list targets it has to wait for after colons,
+ * e.g. `G-DB,S-APP:G-DB` restarts S-APP once G-DB is up. Targets without pending
+ * dependencies are handed out together, so independent ones can run in parallel.
+ */
+class RestartPlan{
+public:
+    /**
+     * @return true and empty string if arg was parsed; false and error message on unknown dependency or cycle
+     */
+    std::pair<bool, std::string> parse(const std::string& arg);
+
+    const std::vector<std::string>& targets() const {return m_targets;}
+    std::vector<std::string> dependencies(const std::string& target) const;
+
+    /**
+     * @return Targets whose dependencies all finished successfully, they are marked as started
+     */
+    std::vector<std::string> next();
+
+    /**
+     * @return Targets which won't be started because they (transitively) depend on failed target
+     */
+    std::vector<std::string> finished(const std::string& target, const bool& ok);
+    bool done() const {return m_finished.size() == m_targets.size();}
+private:
+    static std::string normalize(const std::string& target);
+
+    std::vector<std::string> m_targets;
+    std::map<std::string, std::vector<std::string>> m_dependencies;
+    std::set<std::string> m_started;
+    std::set<std::string> m_finished;
+    std::set<std::string> m_succeeded;
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef TASK_EXECUTOR_HPP
+#define TASK_EXECUTOR_HPP
+
+#include <queue>
+#include <cassert>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <future>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
+
+/**
+ * @class TaskExecutor
+ *
+ * @brief Fixed number of worker threads running submitted tasks in order of submission.
+ *
+ * Used instead of std::async, so the number of threads stays the same no matter how many
+ * operations are in flight. Tasks must not wait for other tasks of the same executor: once all
+ * workers wait, nothing runs the tasks they wait for. Submitting from a worker thread is asserted against.
+ */
+class TaskExecutor{
+public:
+    explicit TaskExecutor(const std::size_t& threads);
+    ~TaskExecutor();
+    TaskExecutor(const TaskExecutor&) = delete;
+    TaskExecutor& operator=(const TaskExecutor&) = delete;
+
+    /**
+     * @brief Executor shared by the whole application, sized by the number of cores
+     */
+    static TaskExecutor& shared();
+
+    template<typename Function>
+    std::future<std::invoke_result_t<Function>> submit(Function&& function){
+        // every caller waits for what it submitted, on a worker that may deadlock the executor
+        assert(!isWorkerThread());
+        using Result = std::invoke_result_t<Function>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+        auto future = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push([task](){ (*task)(); });
+        }
+        m_ready.notify_one();
+        return future;
+    }
+
+    std::size_t threads() const {return m_workers.size();}
+    /**
+     * @return true if called from one of the executor's own workers
+     */
+    bool isWorkerThread() const;
+private:
+    void run();
+
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    bool m_stopping;
+};
+
+#endif
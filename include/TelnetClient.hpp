@@ -2,49 +2,150 @@
 #define TELNET_CLIENT_HPP
 
 #include <SFML/Network.hpp>
+#include <deque>
+#include <mutex>
 #include <future>
-#include <thread>
 #include <atomic>
+#include <chrono>
 #include <unordered_map>
 #include <functional>
 #include "Configuration.hpp"
+#include "OutputCapture.hpp"
+#include "TelnetDecoder.hpp"
+#include "OutputFilter.hpp"
 
+/**
+ * @class TelnetClient
+ *
+ * @brief Telnet session served by the shared EventLoop.
+ *
+ * The client has no threads of its own: received data is processed on the loop thread and
+ * commands are queued, each one is sent when the previous one got its prompt back. Results
+ * are delivered through futures, so any number of sessions and commands in flight costs no
+ * extra threads.
+ */
 class TelnetClient{
+    using DataCallback = std::function<void(const char*, const std::size_t&)>;
+
+    struct Command{
+        std::string m_command;
+        bool m_showResult = false;
+        bool m_exitImmediately = false;
+        bool m_showNewLine = true;
+        std::shared_ptr<OutputCapture> m_capture;
+        DataCallback m_onData;
+        std::function<bool()> m_stop;
+        bool m_interrupted = false;
+        bool m_outputStarted = false;
+        std::string m_data;
+        std::chrono::steady_clock::time_point m_lastActivity;
+        std::promise<std::string> m_promise;
+    };
+
+    enum class LoginStage{
+        Username,
+        Password,
+        Prompt
+    };
+
+    struct Login{
+        std::string m_username;
+        std::string m_password;
+        std::string m_script;
+        LoginStage m_stage = LoginStage::Username;
+        std::promise<bool> m_promise;
+    };
+
     sf::TcpSocket m_socket;
     unsigned char m_buffer[4096];
-    std::thread m_readThread;
-    std::atomic<bool> m_keepReading;
-    std::atomic<bool> m_blockReading;
+    std::size_t m_loopId;
+    std::atomic<bool> m_connected;
+    std::mutex m_mutex;
+    std::mutex m_sendMutex;
+    std::deque<std::shared_ptr<Command>> m_commands;
     std::string m_accumulatedData;
     std::string m_home;
     std::string m_pwd;
     std::string m_source;
-    sf::Clock keepAliveClock;
-    bool m_showThreadOutput;
+    std::string m_prompt;
+    std::chrono::steady_clock::time_point m_lastSent;
+    TelnetDecoder m_decoder;
+    std::atomic<bool> m_showThreadOutput;
+    std::shared_ptr<OutputFilter> m_outputFilter;
+    std::shared_ptr<Login> m_login;
+    std::string m_pipelinedScript;
+    std::future<std::string> m_pipelinedResult;
 public:
     TelnetClient();
     ~TelnetClient();
     bool connect(const sf::IpAddress& ip, const uint16_t& port = 23);
-    bool login(const std::string& username, const std::string& password);
+    /**
+     * @brief Logs in as soon as the server asks for credentials, no fixed delays
+     *
+     * Every step is triggered by the received prompts, including those received before the call.
+     *
+     * @param initialScript When not empty, ". initialScript" is sent the moment the shell prompt
+     *                      appears; executeInitialScript with the same script then only awaits it
+     *
+     * @return true once the shell prompt appeared; false on rejected credentials or timeout
+     */
+    bool login(const std::string& username, const std::string& password, const std::string& initialScript = "");
     std::future<std::string> executeCommand(const std::string& command, const bool& showResult = false, const bool& exitImmediately = false, const bool& outputNewLine = true);
+    /**
+     * @brief Executes command passing its output to the capture instead of accumulating it
+     *
+     * Memory used stays constant regardless of the output volume.
+     *
+     * @return Future holding the captured tail of the output
+     */
+    std::future<std::string> executeCommand(const std::string& command, const std::shared_ptr<OutputCapture>& capture, const bool& showResult = false);
+    /**
+     * @brief Executes never ending command (like tlog) and passes its output as it arrives
+     *
+     * When stop returns true, command is interrupted with Ctrl-C and the shell prompt is awaited.
+     * Both callbacks are called from the event loop thread.
+     *
+     * @param command Command to be executed
+     * @param onData Receives decoded output chunks
+     * @param stop Polled between receives, true ends the command
+     *
+     * @return true if the command was streamed until stopped; false on connection error
+     */
+    bool stream(const std::string& command, const DataCallback& onData, const std::function<bool()>& stop);
     void showThreadOutput(const bool& val);
+    /**
+     * @brief Filters everything printed from received output, nullptr prints everything
+     */
+    void setOutputFilter(const std::shared_ptr<OutputFilter>& filter);
     bool send(const std::string& str);
     bool write(const uint8_t*, const size_t& size);
     bool write(const std::string& text);
     bool isConnected() const;
     void close();
-    void registerCallback(const std::string& trigger, const std::function<void()>& func){
-        m_callbacks[trigger] = func;
-    }
+    void registerCallback(const std::string& trigger, const std::function<void()>& func);
     bool executeInitialScript(const std::string& script);
     const std::string& home() const {return m_home;}
     const std::string& pwd() const {return m_pwd;}
     const std::string& source() const {return m_source;}
+    /**
+     * @brief Shell prompt as it looked after the initial script
+     */
+    const std::string& prompt() const {return m_prompt;}
     void cdHome();
 private:
-    void handleReadThread();
-    void handleOption(const uint8_t& command, const uint8_t& option);
+    std::future<std::string> enqueue(const std::shared_ptr<Command>& command);
+    void sendNext();
+    void finishCommand();
+    void onReadable();
+    void onTick();
+    void handleCommandOutput(Command& command, const std::string& chunk);
+    void advanceLogin();
+    void abortLogin();
+    void handleIdleOutput(const std::string& chunk, std::vector<std::function<void()>>& triggered);
+    void disconnected();
+    std::size_t decodeReceived(const std::size_t& received);
+    void print(const std::string& text);
     std::unordered_map<std::string, std::function<void()>> m_callbacks;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,78 @@
+#ifndef TELNET_DECODER_HPP
+#define TELNET_DECODER_HPP
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Telnet{
+const uint8_t SE = 240;
+const uint8_t SB = 250;
+const uint8_t WILL = 251;
+const uint8_t WONT = 252;
+const uint8_t DO = 253;
+const uint8_t DONT = 254;
+const uint8_t IAC = 255;
+
+const uint8_t OPT_ECHO = 1;
+const uint8_t OPT_SGA = 3;
+const uint8_t OPT_NAWS = 31;
+}
+
+/**
+ * @class TelnetDecoder
+ *
+ * @brief Stateful telnet protocol decoder working in place over received buffers.
+ *
+ * Strips IAC commands and subnegotiations from the data stream, also when they are split
+ * between two receives, and answers option negotiation following the RFC 1143 rules so
+ * that no negotiation loops arise. SUPPRESS-GO-AHEAD and ECHO are accepted from the server,
+ * SUPPRESS-GO-AHEAD and NAWS are offered by the client, everything else is refused.
+ */
+class TelnetDecoder{
+public:
+    TelnetDecoder(const uint16_t& width = 200, const uint16_t& height = 50);
+
+    /**
+     * @brief Removes telnet commands from the buffer
+     *
+     * @param data Buffer with received bytes, text is compacted to its beginning
+     * @param size Number of received bytes
+     *
+     * @return Number of text bytes left at the beginning of the buffer
+     */
+    std::size_t decode(uint8_t* data, const std::size_t& size);
+
+    /**
+     * @brief Requests sent right after connecting, so the server doesn't have to ask for them.
+     */
+    std::vector<uint8_t> initialRequests();
+
+    /**
+     * @brief Returns replies produced by decoding since the last call, which have to be sent to the server.
+     */
+    std::vector<uint8_t> takeReplies();
+    bool hasReplies() const {return !m_replies.empty();}
+
+    void reset();
+    bool serverEchoes() const {return m_remote[Telnet::OPT_ECHO] == OptionState::Yes;}
+    bool goAheadSuppressed() const {return m_remote[Telnet::OPT_SGA] == OptionState::Yes;}
+private:
+    enum class State { Data, Iac, Negotiation, Subnegotiation, SubnegotiationIac };
+    enum class OptionState : uint8_t { No, Yes, WantYes };
+
+    void negotiate(const uint8_t& verb, const uint8_t& option);
+    void reply(const uint8_t& verb, const uint8_t& option);
+    void sendWindowSize();
+
+    State m_state;
+    uint8_t m_verb;
+    std::array<OptionState, 256> m_local;
+    std::array<OptionState, 256> m_remote;
+    std::vector<uint8_t> m_replies;
+    const uint16_t m_width;
+    const uint16_t m_height;
+};
+
+#endif
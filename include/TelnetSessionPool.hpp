@@ -0,0 +1,96 @@
+#ifndef TELNET_SESSION_POOL_HPP
+#define TELNET_SESSION_POOL_HPP
+
+#include <list>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <condition_variable>
+#include <unordered_map>
+#include "TelnetClient.hpp"
+#include "Configuration.hpp"
+
+/**
+ * @class TelnetSessionPool
+ *
+ * @brief Keeps logged-in telnet sessions per host and hands them out to concurrent operations.
+ *
+ * Sessions are opened lazily (connect, login and initial script) up to a per-host limit.
+ * An idle session is health-checked before being handed out again and sessions idle for
+ * longer than the idle timeout are closed.
+ */
+class TelnetSessionPool{
+    struct Session{
+        std::unique_ptr<TelnetClient> m_client;
+        bool m_busy;
+        std::chrono::steady_clock::time_point m_lastUsed;
+    };
+    struct HostSessions{
+        std::list<Session> m_sessions;
+        std::size_t m_opening = 0;
+    };
+public:
+    /**
+     * @brief Move-only handle to a pooled session, gives the session back to the pool on destruction.
+     */
+    class Lease{
+    public:
+        Lease() : m_pool(nullptr), m_client(nullptr) {}
+        Lease(TelnetSessionPool* pool, const std::string& alias, TelnetClient* client) : m_pool(pool), m_alias(alias), m_client(client) {}
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease() {release();}
+
+        void release();
+        explicit operator bool() const {return m_client != nullptr;}
+        TelnetClient* operator->() const {return m_client;}
+        TelnetClient& operator*() const {return *m_client;}
+    private:
+        TelnetSessionPool* m_pool;
+        std::string m_alias;
+        TelnetClient* m_client;
+    };
+
+    TelnetSessionPool(const std::size_t& maxSessionsPerHost = 4, const std::chrono::seconds& idleTimeout = std::chrono::seconds(300));
+    ~TelnetSessionPool();
+
+    /**
+     * @brief Returns an idle session for the host, opening a new one if the limit allows it.
+     *
+     * If every session of the host is busy and the limit is reached, waits until one is released.
+     *
+     * @param host Host for which the session is requested
+     * @param timeout Maximum time to wait for a session to become available
+     *
+     * @return Lease holding the session, empty lease if no session could be obtained
+     */
+    Lease acquire(const HostData& host, const std::chrono::milliseconds& timeout = std::chrono::seconds(60));
+
+    /**
+     * @brief Closes every idle session which has not been used for longer than the idle timeout.
+     */
+    void reapIdle();
+    void closeAll();
+    void setMaxSessionsPerHost(const std::size_t& max);
+    std::size_t sessions(const std::string& alias);
+private:
+    friend class Lease;
+    std::unique_ptr<TelnetClient> open(const HostData& host);
+    bool isHealthy(TelnetClient& client, const std::chrono::steady_clock::time_point& lastUsed);
+    void giveBack(const std::string& alias, TelnetClient* client);
+    /**
+     * @brief Removes expired idle sessions from the pool, the caller closes them once the mutex is unlocked
+     */
+    std::vector<std::unique_ptr<TelnetClient>> takeExpiredLocked();
+
+    std::unordered_map<std::string, HostSessions> m_hosts;
+    std::mutex m_mutex;
+    std::condition_variable m_released;
+    std::size_t m_maxSessionsPerHost;
+    const std::chrono::seconds m_idleTimeout;
+};
+
+#endif
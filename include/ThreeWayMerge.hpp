@@ -0,0 +1,44 @@
+#ifndef THREE_WAY_MERGE_HPP
+#define THREE_WAY_MERGE_HPP
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <string_view>
+
+/**
+ * @struct MergeResult
+ * @brief Merged text, valid only if there were no conflicts
+ */
+struct MergeResult{
+    bool m_clean = true;
+    std::size_t m_conflicts = 0;
+    std::string m_text;
+};
+
+/**
+ * @class ThreeWayMerge
+ *
+ * @brief Merges changes of two descendants of a common base, line by line, like diff3.
+ *
+ * Lines are interned into numbers, so diffs compare integers only; line endings are ignored
+ * when comparing (files downloaded in ASCII mode end with CRLF). Diffs use Myers' algorithm
+ * after trimming common prefix and suffix. Regions changed on one side only take that side,
+ * regions changed the same way on both sides are taken once, anything else is a conflict.
+ */
+class ThreeWayMerge{
+public:
+    static MergeResult merge(std::string_view base, std::string_view local, std::string_view remote);
+
+    /**
+     * @return Pairs of indices of matching lines of first and second sequence, in increasing order
+     */
+    static std::vector<std::pair<std::size_t, std::size_t>> diff(const std::vector<int>& first, const std::vector<int>& second);
+
+    /**
+     * @return Lines including their line ending, last one may be without it
+     */
+    static std::vector<std::string_view> splitLines(std::string_view text);
+};
+
+#endif
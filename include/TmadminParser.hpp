@@ -0,0 +1,50 @@
+#ifndef TMADMIN_PARSER_HPP
+#define TMADMIN_PARSER_HPP
+
+#include <string>
+#include <vector>
+
+/**
+ * @struct ServerState
+ * @brief One server row of tmadmin `psr` output
+ */
+struct ServerState{
+    std::string m_program;
+    std::string m_group;
+    int m_id = 0;
+    std::string m_status;
+};
+
+/**
+ * @class TmadminParser
+ *
+ * @brief Incrementally reads server rows of tmadmin `psr` output and decides if restart targets are up.
+ *
+ * Lines are fed as they arrive; only rows following the `----` separator of the psr table are kept.
+ * Program names truncated by tmadmin (ending with '+') are matched by prefix.
+ */
+class TmadminParser{
+public:
+    void parseLine(const std::string& line);
+    void reset();
+    const std::vector<ServerState>& servers() const {return m_servers;}
+
+    /**
+     * @brief Target is ready if at least one of its servers runs and none of them is dead or restarting
+     *
+     * @param target env (whole domain), S-[SERV-NAME] or G-[GROUP-NAME]
+     */
+    bool isReady(const std::string& target) const;
+
+    /**
+     * @return Shell command printing psr table for the target
+     */
+    static std::string pollCommand(const std::string& target);
+private:
+    static bool matchesProgram(const std::string& program, const std::string& name);
+
+    std::vector<ServerState> m_servers;
+    bool m_inTable = false;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef TRANSFER_MANIFEST_HPP
+#define TRANSFER_MANIFEST_HPP
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <optional>
+#include <filesystem>
+
+/**
+ * @class TransferManifest
+ *
+ * @brief Remembers content of every file last pushed to a host, as base for three-way merges.
+ *
+ * Entries are keyed by host alias and remote path. Contents are stored once per hash in
+ * `objects` subdirectory, index lines `alias hash remote` are kept in `manifest.txt`.
+ */
+class TransferManifest{
+public:
+    /**
+     * @param directory Where the manifest lives, index is read immediately
+     */
+    TransferManifest(const std::filesystem::path& directory);
+
+    /**
+     * @brief Stores the file as the content pushed to remote path of the host
+     */
+    bool record(const std::string& alias, const std::filesystem::path& remote, const std::filesystem::path& file);
+
+    /**
+     * @brief Drops the entry, e.g. when the remote file was deleted
+     */
+    void forget(const std::string& alias, const std::filesystem::path& remote);
+
+    /**
+     * @return Content last pushed to remote path of the host or std::nullopt if it isn't known
+     */
+    std::optional<std::string> base(const std::string& alias, const std::filesystem::path& remote) const;
+    std::size_t entries() const;
+    bool readIndex();
+private:
+    using Key = std::pair<std::string, std::string>;
+
+    void removeUnreferenced(const std::string& hash);
+    std::filesystem::path objectPath(const std::string& hash) const;
+    bool saveIndexLocked();
+
+    const std::filesystem::path m_directory;
+    std::map<Key, std::string> m_entries;
+    mutable std::mutex m_mutex;
+};
+
+#endif
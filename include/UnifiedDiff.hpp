@@ -0,0 +1,26 @@
+#ifndef UNIFIED_DIFF_HPP
+#define UNIFIED_DIFF_HPP
+
+#include <string>
+#include <string_view>
+
+/**
+ * @class UnifiedDiff
+ *
+ * @brief Renders differences of two texts in unified format, as `diff -u` does.
+ *
+ * Lines are compared without their line endings, so a file downloaded in ASCII mode
+ * doesn't differ from its local copy in every line.
+ */
+class UnifiedDiff{
+public:
+    /**
+     * @param context Number of unchanged lines shown around each change
+     *
+     * @return Diff with `---`/`+++` header and hunks; empty if the texts have the same lines
+     */
+    static std::string render(std::string_view from, std::string_view to, const std::string& fromName,
+                              const std::string& toName, const std::size_t& context = 3);
+};
+
+#endif
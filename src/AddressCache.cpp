@@ -0,0 +1,60 @@
+#include "AddressCache.hpp"
+
+AddressCache& AddressCache::instance()
+{
+    static AddressCache cache;
+    return cache;
+}
+
+AddressCache::AddressCache() : m_ttl(std::chrono::minutes(10))
+{
+
+}
+
+std::optional<sf::IpAddress> AddressCache::resolve(const std::string& hostname)
+{
+    std::promise<std::optional<sf::IpAddress>> promise;
+    std::shared_future<std::optional<sf::IpAddress>> address;
+    bool resolving = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto itr = m_entries.find(hostname);
+        if(itr != m_entries.end() && std::chrono::steady_clock::now() - itr->second.m_resolved < m_ttl){
+            address = itr->second.m_address;
+        } else{
+            // this caller resolves, concurrent callers wait for the same future
+            address = promise.get_future().share();
+            resolving = true;
+            m_entries[hostname] = {address, std::chrono::steady_clock::now()};
+        }
+    }
+    if(!resolving){
+        return address.get();
+    }
+    const auto& resolved = sf::IpAddress::resolve(hostname);
+    promise.set_value(resolved);
+    if(!resolved.has_value()){
+        forget(hostname); // don't keep failures, name may become resolvable
+    }
+    return resolved;
+}
+
+void AddressCache::seed(const std::string& hostname, const sf::IpAddress& address)
+{
+    std::promise<std::optional<sf::IpAddress>> promise;
+    promise.set_value(address);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries[hostname] = {promise.get_future().share(), std::chrono::steady_clock::now()};
+}
+
+void AddressCache::forget(const std::string& hostname)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.erase(hostname);
+}
+
+void AddressCache::setTtl(const std::chrono::seconds& ttl)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ttl = ttl;
+}
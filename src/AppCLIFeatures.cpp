@@ -2,6 +2,7 @@
 #include "AppCLIView.hpp"
 #include <thread>
 #include <iostream>
+#include <sstream>
 #include "Utils.hpp"
 #include "Windows.h"
 #include <conio.h>
@@ -55,12 +56,7 @@ void AppCLIFeatures::changeHost(AppCLIController& controller)
     const auto& selectedHost = controller.read();
     if(m_model.config().setValue(ConfigKey::DefaultHost, selectedHost)){
         m_view.writeGreen("Host was changed to: " + selectedHost);
-        if(m_model.isConnectedToFtp()){
-            void(m_model.m_ftp.disconnect());
-        }
-        if(m_model.telnet().isConnected()){
-            m_model.telnet().close();
-        }
+        m_model.disconnect();
     } else{
         m_view.writeRed("Unable to choose: " + selectedHost);
     }
@@ -74,6 +70,8 @@ void AppCLIFeatures::restart(AppCLIController& controller)
     m_view.writeWhite("retux - restarts retux adapter");
     m_view.writeWhite("S-[serv-name] - restarts single server");
     m_view.writeWhite("G-[group-name] - restarts group of servers");
+    m_view.writeWhite("comma separated targets are restarted in parallel");
+    m_view.writeWhite("S-[serv-name]:G-[group-name] - restarts server once the group is up");
     std::string arg = controller.read();
     if(arg.empty()){
         pressEnter(controller);
@@ -86,10 +84,8 @@ void AppCLIFeatures::restart(AppCLIController& controller)
 void AppCLIFeatures::tlog(AppCLIController& controller)
 {
     auto host = m_model.config().getCurrentHost();
-    if(!m_model.telnet().isConnected()){
-        if(!m_model.connectToTelnet(host)){
-            return;
-        }
+    if(!m_model.ensureTelnet(host)){
+        return;
     }
     m_view.writeWhite("Filename which to save to (empty for current date): ");
     std::string filename = controller.read();
@@ -97,7 +93,19 @@ void AppCLIFeatures::tlog(AppCLIController& controller)
         filename = Utils::getCurrentDateTime() + ".txt";
     }
 
-    auto result = m_model.tlog(filename);
+    m_view.writeWhite("Stream straight to local file, without remote file? (y/n)");
+    std::pair<bool, std::string> result;
+    if(controller.yes()){
+        m_view.writeWhite("Filter rules separated by spaces: TEXT, !TEXT, /REGEX/, !/REGEX/ (empty for all): ");
+        std::vector<std::string> rules;
+        std::istringstream stream(controller.read());
+        for(std::string rule; stream >> rule;){
+            rules.push_back(rule);
+        }
+        result = m_model.tlogStream(filename, m_model.makeOutputFilter(rules));
+    } else{
+        result = m_model.tlog(filename);
+    }
     if(result.first){
         m_view.writeWhite("Open downloaded file with notepad++? (y/n)");
         if(controller.yes()){
@@ -109,10 +117,8 @@ void AppCLIFeatures::tlog(AppCLIController& controller)
 
 void AppCLIFeatures::script(AppCLIController& controller)
 {
-    if(!m_model.m_telnet.isConnected()){
-        if(!m_model.connectToTelnet(m_model.config().getCurrentHost())){
-            return;
-        }
+    if(!m_model.ensureTelnet(m_model.config().getCurrentHost())){
+        return;
     }
 
     m_view.writeWhite("Continuous script execution\n@in to go to base path\n@exit to exit to main menu");
@@ -180,20 +186,17 @@ void AppCLIFeatures::transferFiles(AppCLIController& controller)
     }
 
     auto host = m_model.config().getCurrentHost();
+    const bool& needsSource = host.m_remotePath.empty() && m_model.remoteSource().empty();
+    m_model.warmup(host, needsSource);
 
-    if(!m_model.isConnectedToFtp()){
-        m_view.writeWhite("Connecting to ftp server...");
-        if(!m_model.connectToFtp(host)){
-            return;
-        }
+    if(!m_model.ensureFtp(host)){
+        return;
     }
 
-    if(host.m_remotePath.empty() && m_model.m_telnet.source().empty()){
+    if(needsSource){
         m_view.writeWhite("[REMOTE_PATH] is not set, retrieving source path from telnet...");
-        if(!m_model.m_telnet.isConnected()){
-            if(!m_model.connectToTelnet(host)){
-                return;
-            }
+        if(!m_model.ensureTelnet(host)){
+            return;
         }
         if(m_model.m_telnet.source().empty()){
             m_view.writeRed("This host doesn't support transferring files, please set REMOTE_PATH in config file.");
@@ -203,6 +206,8 @@ void AppCLIFeatures::transferFiles(AppCLIController& controller)
         }
     }
 
+    // remote versions are downloaded while the files are being reviewed
+    m_model.prefetch(m_model.m_monitor.filesUpdated());
     for(const auto& file : m_model.m_monitor.filesUpdated()){
         m_view.writeWhite("Update file (y/n): " + file.string());
         if(controller.yes()){
@@ -216,6 +221,7 @@ void AppCLIFeatures::transferFiles(AppCLIController& controller)
             m_model.updateRemoteFile(file, difftool);
         }
     }
+    m_model.stopPrefetch();
 
     for(const auto& file : m_model.m_monitor.filesAdded()){
         m_view.writeWhite("Upload file (y/n): " + file.string());
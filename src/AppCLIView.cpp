@@ -13,9 +13,22 @@ opt("Allowed options"), m_features(model, *this)
     ("list-file", "lists files changed")
     ("transfer", po::value<std::string>(), "send files to remote host\narg values: added, deleted, updated, all")
     ("transfer-branch", po::value<std::string>(), "lists and sends all files modified between current branch and selected branch\narg values: branch to compare with")
+    ("patch", "used with --transfer-branch, sends the changes as one git patch applied on remote host, files which fail to apply are sent whole, difftool is not used")
+    ("hosts", po::value<std::string>(), "used with --transfer or --transfer-branch, sends the same changes to several hosts in parallel, files are overwritten without difftool\narg values: comma separated host aliases or groups (GROUP in config file)")
+    ("build", po::value<std::string>()->implicit_value("make"), "used with --transfer or --transfer-branch, runs build command only in directories with makefile touched by the transfer\narg values: build command (make if no value is passed)")
+    ("pipeline", "used with --build, starts building each directory as soon as its files are transferred, while the other files are still being sent")
+    ("verify", "used with --transfer or --transfer-branch, compares checksums of sent files with their remote copies in one telnet command and sends mismatched files again")
+    ("drift", po::value<std::string>()->implicit_value("changed"), "reports which remote copies equal local files, equal the last push or diverged, with diffs of diverged files\narg values: changed (updated files of current changeset, default), all (every file in LOCAL_PATH)")
+    ("pull", "downloads files changed on remote host into LOCAL_PATH, overwriting local files only after confirmation")
     ("script", po::value<std::string>(), "execute telnet script\narg values: script name to be executed (. dot will be added on beginning)")
-    ("restart", po::value<std::string>(), "restarts specified object\narg values: env (whole domain), retux (adapter), s-[SERV-NAME] (single server), g-[GROUP-NAME]")
+    ("restart", po::value<std::string>(), "restarts specified object\narg values: env (whole domain), retux (adapter), s-[SERV-NAME] (single server), g-[GROUP-NAME], several comma separated targets are restarted in parallel, TARGET:DEPENDENCY restarts target once dependency is up")
     ("tlog", po::value<std::string>()->implicit_value(""), "starts writing log to a file\narg values: filename which to save (if no value is passed, current date will be used)")
+    ("output-log", po::value<std::string>(), "used with --script, streams whole script output to the file, only its tail is kept in memory")
+    ("stream", "used with --tlog, streams log straight to a local file without creating it on remote host")
+    ("filter", po::value<std::vector<std::string>>()->multitoken(), "used with --tlog --stream or --script, shows/saves only lines passing the rules\narg values: TEXT (keep lines containing), !TEXT (drop lines containing), /REGEX/ (keep matching), !/REGEX/ (drop matching)")
+    ("context", po::value<std::size_t>(), "used with --filter, number of lines shown before and after each kept line")
+    ("duration", po::value<int>(), "used with --tlog --stream, stops capture after given number of seconds")
+    ("max-size", po::value<std::size_t>(), "used with --tlog --stream, stops capture after given number of KiB was saved")
     ("no-difftool", "transfering files involves firstly comparing them via difftool, if that option is passed, difftool wont be used")
     ;
 
@@ -58,8 +71,39 @@ int AppCLIView::show(AppCLIController& controller)
         }
 
 
+        std::vector<std::string> hosts;
+        if(vm.count("hosts")){
+            hosts = m_model.config().expandHosts(vm["hosts"].as<std::string>());
+            if(hosts.empty()){
+                writeRed("Error: no valid hosts in " + vm["hosts"].as<std::string>());
+                return 1;
+            }
+        }
+
+        // transfer to current host, followed by verification and build if requested
+        auto transfer = [&](const std::string& arg){
+            const bool patch = vm.count("patch") && vm.count("transfer-branch");
+            const bool pipeline = vm.count("build") && vm.count("pipeline") && !patch;
+            bool ok;
+            if(patch){
+                ok = m_model.transferPatch(vm["transfer-branch"].as<std::string>());
+            } else{
+                ok = pipeline ? m_model.transferAndBuild(arg, useDifftool, vm["build"].as<std::string>()) : m_model.transfer(arg, useDifftool);
+            }
+            if(ok && vm.count("verify")){
+                ok = m_model.verify();
+            }
+            if(ok && vm.count("build") && !pipeline){
+                ok = m_model.rebuild(vm["build"].as<std::string>());
+            }
+            return ok ? 0 : 1;
+        };
+
         if(vm.count("transfer")){
-            return !m_model.transfer(vm["transfer"].as<std::string>(), useDifftool);
+            if(!hosts.empty()){
+                return !m_model.transfer(vm["transfer"].as<std::string>(), hosts);
+            }
+            return transfer(vm["transfer"].as<std::string>());
         }
 
         if(vm.count("transfer-branch")){
@@ -68,11 +112,34 @@ int AppCLIView::show(AppCLIController& controller)
             m_model.monitor().setStrategy(std::move(branchStrategy));
             if(!m_model.listChangedFiles())
                 return 0;
-            return !m_model.transfer("all", useDifftool);
+            if(!hosts.empty()){
+                return !m_model.transfer("all", hosts);
+            }
+            return transfer("all");
+        }
+
+        if(vm.count("drift")){
+            return !m_model.drift(vm["drift"].as<std::string>());
+        }
+
+        if(vm.count("pull")){
+            return !m_model.pull([this, &controller](const std::string& question, const std::vector<std::filesystem::path>&){
+                writeWhite(question + " (y/n):");
+                return controller.yes();
+            });
+        }
+
+        std::shared_ptr<OutputFilter> filter;
+        if(vm.count("filter")){
+            filter = m_model.makeOutputFilter(vm["filter"].as<std::vector<std::string>>(), vm.count("context") ? vm["context"].as<std::size_t>() : 0);
+            if(!filter){
+                return 1;
+            }
         }
 
         if(vm.count("script")){
-            return !m_model.script(". " + vm["script"].as<std::string>());
+            const auto& outputLog = vm.count("output-log") ? vm["output-log"].as<std::string>() : "";
+            return !m_model.script(". " + vm["script"].as<std::string>(), outputLog, filter);
         }
 
         if(vm.count("restart")){
@@ -80,8 +147,16 @@ int AppCLIView::show(AppCLIController& controller)
         }
 
         if(vm.count("tlog")){
-            const auto& filename = vm["tlog"].as<std::string>();
-            return !m_model.tlog(filename.empty() ? Utils::getCurrentDateTime() + ".txt": filename).first;
+            auto filename = vm["tlog"].as<std::string>();
+            if(filename.empty()){
+                filename = Utils::getCurrentDateTime() + ".txt";
+            }
+            if(vm.count("stream")){
+                const auto& duration = std::chrono::seconds(vm.count("duration") ? vm["duration"].as<int>() : 0);
+                const auto& maxBytes = vm.count("max-size") ? vm["max-size"].as<std::size_t>() * 1024 : 0;
+                return !m_model.tlogStream(filename, filter, duration, maxBytes).first;
+            }
+            return !m_model.tlog(filename).first;
         }
         
 
@@ -119,6 +194,8 @@ void AppCLIView::executeInteractiveFeature(AppCLIController& controller, const i
 
     FeatureCallback callback = itr->second.second;
     callback(controller);
+    // files stay mapped only while a feature runs, the user edits them in between
+    m_model.releaseLocalFiles();
 }
 
 void AppCLIView::restart()
@@ -147,6 +224,8 @@ void AppCLIView::updateBad(const std::string& str)
 void AppCLIView::drawMenu()
 {
     writeGreen("Current host: " + m_model.config().getCurrentHost().m_alias);
+    // most options need the connections, open them while the user chooses
+    m_model.warmup(m_model.config().getCurrentHost());
 
     for(const auto& feature : m_features.getFeatures()){
         std::cout << '[' << feature.first << "] - " << feature.second.first << std::endl;
@@ -1,30 +1,203 @@
 #include "AppModel.hpp"
 #include <boost/algorithm/string/replace.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
 #include <iostream>
+#include <future>
+#include <cstring>
+#include <fstream>
+#include <cctype>
+#include <sstream>
+#include <iomanip>
+#include <atomic>
+#include <set>
 #include "Utils.hpp"
+#include "AsyncFileWriter.hpp"
+#include "BuildOutputParser.hpp"
+#include "TaskExecutor.hpp"
+#include "AddressCache.hpp"
+#include "RestartPlan.hpp"
+#include "TmadminParser.hpp"
+#include "Checksum.hpp"
+#include "ThreeWayMerge.hpp"
+#include "UnifiedDiff.hpp"
+#include "FileChunker.hpp"
+#include "LineEndings.hpp"
 
-AppModel::AppModel() : m_configuration(Utils::getExecutablePath() + "/config.txt"), m_monitor(m_configuration.getValue(ConfigKey::LocalPath))
+// FTP session which replied within that time is considered alive without asking the server
+static const std::chrono::seconds FTP_PROBE_AFTER(30);
+// booted target whose servers are not all up within that time is reported as failed
+static const std::chrono::seconds RESTART_READY_TIMEOUT(180);
+static const std::chrono::seconds RESTART_POLL_INTERVAL(2);
+// FTP sessions downloading remote files in background during transfer
+static const std::size_t PREFETCH_SESSIONS = 2;
+// FTP sessions uploading chunks of one large file
+static const std::size_t CHUNK_SESSIONS = 4;
+// numbers directories of LF copies, so threads sending the same file don't share one
+static std::atomic<unsigned> s_sendableCopies(0);
+// how many times mismatched files are sent again before verification gives up
+static const int VERIFY_RETRIES = 2;
+// printed after the build command, so its exit code can be told apart from the build output
+static const std::string BUILD_STATUS_MARKER = "REBUILD_EXIT_STATUS=";
+
+AppModel::AppModel() : m_configuration(Utils::getExecutablePath() + "/config.txt"), m_monitor(m_configuration.getValue(ConfigKey::LocalPath)),
+                       m_facts(Utils::getExecutablePath() + "/host_facts.txt"), m_cache(Utils::getExecutablePath() + "/cache"), m_manifest(Utils::getExecutablePath() + "/manifest"),
+                       m_buildHistory(Utils::getExecutablePath() + "/build_times.txt"),
+                       m_prefetcher(Utils::getExecutablePath() + "/temp/prefetch", PREFETCH_SESSIONS), m_chunkThreshold(64ull * 1024 * 1024),
+                       m_lineEndings(m_configuration.getValue(ConfigKey::BinaryFiles)),
+                       m_ftpAlive(false)
 {
+    const auto& sessions = m_configuration.getValue(ConfigKey::TelnetSessions);
+    if(!sessions.empty()){
+        try{
+            m_telnetPool.setMaxSessionsPerHost(std::stoul(sessions));
+        } catch(const std::exception&){
+            std::cerr << "Invalid TELNET_SESSIONS value: " << sessions << std::endl;
+        }
+    }
+    const auto& ttl = m_configuration.getValue(ConfigKey::FactsTtl);
+    if(!ttl.empty()){
+        try{
+            m_facts.setTtl(std::chrono::hours(std::stoul(ttl)));
+        } catch(const std::exception&){
+            std::cerr << "Invalid FACTS_TTL value: " << ttl << std::endl;
+        }
+    }
+    const auto& cacheSize = m_configuration.getValue(ConfigKey::CacheSize);
+    if(!cacheSize.empty()){
+        try{
+            m_cache.setBudget(std::stoull(cacheSize) * 1024 * 1024);
+        } catch(const std::exception&){
+            std::cerr << "Invalid CACHE_SIZE value: " << cacheSize << std::endl;
+        }
+    }
+    const auto& chunkThreshold = m_configuration.getValue(ConfigKey::ChunkThreshold);
+    if(!chunkThreshold.empty()){
+        try{
+            m_chunkThreshold = std::stoull(chunkThreshold) * 1024 * 1024;
+        } catch(const std::exception&){
+            std::cerr << "Invalid CHUNK_THRESHOLD value: " << chunkThreshold << std::endl;
+        }
+    }
+}
 
+AppModel::~AppModel()
+{
+    m_prefetcher.cancel();
+    // warmup tasks use the model, they must not outlive it
+    for(auto* warmup : {&m_ftpWarmup, &m_telnetWarmup}){
+        if(warmup->valid()){
+            warmup->wait();
+        }
+    }
 }
 
 bool AppModel::changeFTPDirectory(const std::filesystem::path& path)
 {
     for(const auto& component : path){
-        if(!m_ftp.changeDirectory(component.string()).isOk()){
-            notifyBad("Error: changing directory to " + component.string() + " of " + path.string());
+        if(!track(m_ftp.changeDirectory(component.string())).isOk()){
+            if(m_ftpAlive){ // lost connection is handled by ftpRetry
+                notifyBad("Error: changing directory to " + component.string() + " of " + path.string());
+            }
             return false;
         }
     }
     return true;
 }
 
+static std::string seconds(const std::chrono::milliseconds& elapsed)
+{
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1) << elapsed.count() / 1000.0 << " s";
+    return ss.str();
+}
+
+static bool isConnectionError(const sf::Ftp::Response& response)
+{
+    switch(response.getStatus()){
+        case sf::Ftp::Response::Status::ConnectionClosed:
+        case sf::Ftp::Response::Status::ConnectionFailed:
+        case sf::Ftp::Response::Status::ServiceUnavailable:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// changes directory component by component, starting from home so paths relative to it work on every call
+static sf::Ftp::Response changeDirectory(sf::Ftp& ftp, const std::string& home, const std::filesystem::path& path)
+{
+    auto response = ftp.changeDirectory(home);
+    for(auto itr = path.begin(); response.isOk() && itr != path.end(); ++itr){
+        response = ftp.changeDirectory(itr->string());
+    }
+    return response;
+}
+
+// size and modification time of remote file, std::nullopt if the server doesn't tell
+static std::optional<RemoteStat> statRemote(sf::Ftp& ftp, const std::filesystem::path& remote)
+{
+    auto lastWord = [](const std::string& message){
+        const auto& end = message.find_last_not_of(" \r\n");
+        if(end == std::string::npos){
+            return std::string();
+        }
+        const auto& begin = message.find_last_of(' ', end);
+        return message.substr(begin == std::string::npos ? 0 : begin + 1, end - (begin == std::string::npos ? 0 : begin + 1) + 1);
+    };
+    const auto& size = ftp.sendCommand("SIZE", remote.generic_string());
+    if(!size.isOk()){
+        return std::nullopt;
+    }
+    const auto& modified = ftp.sendCommand("MDTM", remote.generic_string());
+    if(!modified.isOk()){
+        return std::nullopt;
+    }
+    RemoteStat stat;
+    try{
+        stat.m_size = std::stoull(lastWord(size.getMessage()));
+    } catch(const std::exception&){
+        return std::nullopt;
+    }
+    stat.m_modified = lastWord(modified.getMessage());
+    return stat;
+}
+
+sf::Ftp::Response AppModel::track(const sf::Ftp::Response& response)
+{
+    if(isConnectionError(response)){
+        m_ftpAlive = false;
+    } else{
+        // any reply, even an error, means the session is alive
+        m_ftpAlive = true;
+        m_ftpLastReply = std::chrono::steady_clock::now();
+    }
+    return response;
+}
+
+bool AppModel::ftpRetry(const std::function<bool()>& commands)
+{
+    if(commands()){
+        return true;
+    }
+    if(m_ftpAlive){
+        return false; // failed for other reason than connection
+    }
+    const auto& host = m_configuration.getCurrentHost();
+    notify("FTP connection lost, reconnecting to " + host.m_alias + "...");
+    if(!connectToFtp(host, true)){
+        notifyBad("Error: unable to reconnect via FTP to: " + host.m_alias);
+        return false;
+    }
+    return commands();
+}
+
 std::filesystem::path AppModel::getRemoteFileEquivalent(const std::filesystem::path& file)
 {
     std::string remote;
     auto host = m_configuration.getCurrentHost();
     if(host.m_remotePath.empty()){
-        remote = m_telnet.source() + '/' + file.string();
+        remote = remoteSource() + '/' + file.string();
     } else if (!host.m_remotePath.empty()){
         remote = host.m_remotePath + (host.m_remotePath.back() == '/' ? "" : "/") + file.string();
     } else{
@@ -38,13 +211,22 @@ std::pair<bool, std::string> AppModel::uploadAddedFile(const std::filesystem::pa
     auto local_file = m_configuration.getValue(ConfigKey::LocalPath) + file.string();
     std::pair<bool, std::string> ret;
     const auto& remote = getRemoteFileEquivalent(file.string());
-    if(changeFTPDirectory(remote.parent_path())){
-        ret.first = m_ftp.upload(local_file, "", sf::Ftp::TransferMode::Ascii).isOk();
-        if(ret.first && !suppressOutput){
-            notifyGood("Success: file uploaded " + local_file);
-        } else if(!suppressOutput){
-            notifyBad("Error: when uploading file " + local_file);
-        }
+    const auto& sent = sendable(local_file);
+    if(isChunked(sent)){
+        ret.first = uploadChunked(sent, remote);
+    } else{
+        ret.first = ftpRetry([&](){
+            return changeFTPDirectory(remote.parent_path()) && track(m_ftp.upload(sent, "", sf::Ftp::TransferMode::Binary)).isOk();
+        });
+    }
+    discard(sent, local_file);
+    if(ret.first){
+        m_manifest.record(m_configuration.getCurrentHost().m_alias, remote, local_file);
+    }
+    if(ret.first && !suppressOutput){
+        notifyGood("Success: file uploaded " + local_file);
+    } else if(!suppressOutput){
+        notifyBad("Error: when uploading file " + local_file);
     }
     ret.second = remote.string();
     return ret;
@@ -54,13 +236,21 @@ std::pair<bool, std::string> AppModel::updateRemoteFile(const std::filesystem::p
 {
     auto local_file = m_configuration.getValue(ConfigKey::LocalPath) + file.string();
     auto remote = getRemoteFileEquivalent(file);
-    auto result = downloadRemoteFile(file.string(), true);
+    std::pair<bool, std::string> result;
+    const auto& prefetched = m_prefetcher.take(remote);
+    if(prefetched.has_value()){
+        result = std::make_pair(true, prefetched->string());
+    } else{
+        result = downloadRemoteFile(file.string(), true);
+    }
     if(!result.first){
         notifyBad("Error: when retrieving remote file: " + remote.string());
         return std::make_pair(false, result.second);
     }
     std::string fileToUpload;
-    if(useDifftool){
+    if(useDifftool && mergeWithBase(remote, local_file, result.second, suppressOutput)){
+        fileToUpload = result.second;
+    } else if(useDifftool){
         // force file change
         if(!difftool(result.second, local_file)){
             if(m_configuration.getValue(ConfigKey::DifftoolSide) == "RIGHT"){
@@ -76,6 +266,10 @@ std::pair<bool, std::string> AppModel::updateRemoteFile(const std::filesystem::p
         fileToUpload = local_file;
     }
     result.first = transferFile(fileToUpload, remote, true);
+    if(result.first){
+        // base is what the local file holds, whatever remote-only edits the upload kept merge against it next time
+        m_manifest.record(m_configuration.getCurrentHost().m_alias, remote, local_file);
+    }
     std::filesystem::remove(result.second);
     if(result.first){
         if(!suppressOutput){
@@ -96,15 +290,16 @@ std::pair<bool, std::string> AppModel::deleteRemoteFile(const std::filesystem::p
     } else{
         remote = getRemoteFileEquivalent(file.string());
     }
-    if(changeFTPDirectory(remote.parent_path())){
-        ret.first = m_ftp.deleteFile(remote).isOk();
-        if(ret.first){
-            if(!suppressOutput){
-                notifyGood("Success: deleted file " + remote.string());
-            }
-        } else if(!suppressOutput){
-            notifyBad("Error: unable to delete file " + remote.string());
+    ret.first = ftpRetry([&](){
+        return changeFTPDirectory(remote.parent_path()) && track(m_ftp.deleteFile(remote)).isOk();
+    });
+    if(ret.first){
+        m_manifest.forget(m_configuration.getCurrentHost().m_alias, remote);
+        if(!suppressOutput){
+            notifyGood("Success: deleted file " + remote.string());
         }
+    } else if(!suppressOutput){
+        notifyBad("Error: unable to delete file " + remote.string());
     }
     ret.second = remote.string();
     return ret;
@@ -112,66 +307,390 @@ std::pair<bool, std::string> AppModel::deleteRemoteFile(const std::filesystem::p
 
 bool AppModel::transferFile(const std::filesystem::path& file, const std::filesystem::path& to, const bool& suppressOutput)
 {
-    if(m_ftp.changeDirectory(to.parent_path().string()).isOk()){
-        if(m_ftp.upload(file, "", sf::Ftp::TransferMode::Ascii).isOk()){
-            if(!suppressOutput){
-                notifyGood("Success: transfered file " + file.string());
+    const auto& sent = sendable(file);
+    const auto& transferred = isChunked(sent) ? uploadChunked(sent, to.parent_path() / file.filename()) : ftpRetry([&](){
+        return track(m_ftp.changeDirectory(to.parent_path().string())).isOk() &&
+               track(m_ftp.upload(sent, "", sf::Ftp::TransferMode::Binary)).isOk();
+    });
+    discard(sent, file);
+    if(transferred){
+        if(!suppressOutput){
+            notifyGood("Success: transfered file " + file.string());
+        }
+    } else if(!suppressOutput){
+        notifyBad("Error: when transfering file " + file.string());
+    }
+    return transferred;
+}
+
+std::filesystem::path AppModel::sendable(const std::filesystem::path& file)
+{
+    const auto& mapped = m_localFiles.open(file);
+    if(mapped){
+        const auto& content = mapped->view();
+        if(m_lineEndings.kind(file, content) == FileKind::Binary || content.find('\r') == std::string_view::npos){
+            return file;
+        }
+    } else if(m_lineEndings.kind(file) == FileKind::Binary || !LineEndings::hasCr(file)){
+        return file;
+    }
+    // copy keeps the file name, as upload names the remote file after it
+    const std::filesystem::path directory = Utils::getExecutablePath() + "/temp/lf/" + std::to_string(s_sendableCopies++);
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    const auto& converted = mapped ? LineEndings::convertContent(mapped->view(), directory / file.filename(), false) :
+                                     LineEndings::convert(file, directory / file.filename(), false);
+    if(error || !converted){
+        std::filesystem::remove_all(directory, error);
+        return file;
+    }
+    return directory / file.filename();
+}
+
+void AppModel::discard(const std::filesystem::path& sent, const std::filesystem::path& file)
+{
+    if(sent != file){
+        // mapped copy can't be deleted on every system
+        m_localFiles.release(sent);
+        std::error_code error;
+        std::filesystem::remove_all(sent.parent_path(), error);
+    }
+}
+
+void AppModel::localize([[maybe_unused]] const std::filesystem::path& file) const
+{
+#ifdef _WIN32
+    if(m_lineEndings.kind(file) == FileKind::Text){
+        const auto& converted = file.string() + ".crlf";
+        std::error_code error;
+        if(LineEndings::convert(file, converted, true)){
+            std::filesystem::rename(converted, file, error);
+        }
+        // left over only when conversion or rename failed, the file then keeps LF line endings
+        std::filesystem::remove(converted, error);
+    }
+#endif
+}
+
+std::optional<FileChecksum> AppModel::localChecksum(const std::filesystem::path& file)
+{
+    // text files end up on the host with LF line endings
+    const auto& mapped = m_localFiles.open(file);
+    if(mapped){
+        return Checksum::ofData(mapped->view(), m_lineEndings.kind(file, mapped->view()) == FileKind::Text);
+    }
+    return Checksum::ofFile(file, m_lineEndings.kind(file) == FileKind::Text);
+}
+
+FileKind AppModel::localKind(const std::filesystem::path& file)
+{
+    const auto& mapped = m_localFiles.open(file);
+    return mapped ? m_lineEndings.kind(file, mapped->view()) : m_lineEndings.kind(file);
+}
+
+bool AppModel::isChunked(const std::filesystem::path& file) const
+{
+    std::error_code error;
+    const auto& size = std::filesystem::file_size(file, error);
+    return !error && m_chunkThreshold && size >= m_chunkThreshold;
+}
+
+bool AppModel::uploadChunked(const std::filesystem::path& file, const std::filesystem::path& remote)
+{
+    const auto& host = m_configuration.getCurrentHost();
+    const std::filesystem::path directory = Utils::getExecutablePath() + "/temp/chunks";
+    // chunks and checksum come from the mapping sendable() made, the file isn't read again
+    const auto& mapped = m_localFiles.open(file);
+    // two chunks per session, so sessions which finish early take over the rest
+    const auto& chunkSize = std::filesystem::file_size(file) / (2 * CHUNK_SESSIONS) + 1;
+    const auto& chunks = mapped ? FileChunker::split(mapped->view(), file.filename().string(), directory, chunkSize) :
+                                  FileChunker::split(file, directory, chunkSize);
+    if(chunks.empty()){
+        notifyBad("Error: unable to split " + file.string() + " into chunks");
+        return false;
+    }
+    auto cleanup = [&chunks](){
+        for(const auto& chunk : chunks){
+            std::filesystem::remove(chunk);
+        }
+    };
+    // file is already as it should end up on the host
+    auto local = TaskExecutor::shared().submit([file, mapped]() -> std::optional<FileChecksum>{
+        if(mapped){
+            return Checksum::ofData(mapped->view());
+        }
+        return Checksum::ofFile(file);
+    });
+
+    notify("Uploading " + file.string() + " in " + std::to_string(chunks.size()) + " chunks...");
+    std::atomic<std::size_t> next(0);
+    std::vector<std::future<bool>> sessions;
+    for(std::size_t i = 0; i < std::min(CHUNK_SESSIONS, chunks.size()); ++i){
+        sessions.push_back(TaskExecutor::shared().submit([this, &host, &chunks, &next, &remote](){
+            // runs on a worker thread: own FTP session, no notifications
+            sf::Ftp ftp;
+            std::string home;
+            auto connect = [&](){
+                const auto& ip = resolve(host);
+                if(!ip.has_value() || !ftp.connect(ip.value()).isOk() || !ftp.login(host.m_username, host.m_password).isOk()){
+                    return false;
+                }
+                home = ftp.getWorkingDirectory().getDirectory().string();
+                return true;
+            };
+            if(!connect()){
+                return false;
             }
+            for(std::size_t index = next++; index < chunks.size(); index = next++){
+                auto upload = [&](){
+                    auto response = changeDirectory(ftp, home, remote.parent_path());
+                    return response.isOk() ? ftp.upload(chunks[index], "", sf::Ftp::TransferMode::Binary) : response;
+                };
+                auto response = upload();
+                if(isConnectionError(response) && connect()){
+                    response = upload();
+                }
+                if(!response.isOk()){
+                    return false;
+                }
+            }
+            void(ftp.disconnect());
             return true;
-        } else if(!suppressOutput){
-            notifyBad("Error: when transfering file " + file.string());
+        }));
+    }
+    bool uploaded = true;
+    for(auto& session : sessions){
+        uploaded = session.get() && uploaded;
+    }
+    cleanup();
+    const auto& checksum = local.get();
+    const auto& name = remote.filename().string();
+    // joined under a hidden name, the live file is replaced only once the checksum matches
+    const auto& joined = "." + name + ".joining";
+    // parts which made it to the host must not stay there when the file isn't replaced
+    auto removeRemoteParts = [&](){
+        ftpRetry([&](){
+            if(!changeFTPDirectory(remote.parent_path())){
+                return false;
+            }
+            for(const auto& chunk : chunks){
+                void(track(m_ftp.deleteFile(chunk.filename().string())));
+            }
+            void(track(m_ftp.deleteFile(joined)));
+            return m_ftpAlive;
+        });
+    };
+    if(!uploaded || next < chunks.size()){
+        notifyBad("Error: unable to upload chunks of " + file.string());
+        removeRemoteParts();
+        return false;
+    }
+
+    auto session = m_telnetPool.acquire(host);
+    if(!session){
+        notifyBad("Error: unable to open telnet session to " + host.m_alias);
+        removeRemoteParts();
+        return false;
+    }
+    std::string parts;
+    for(const auto& chunk : chunks){
+        parts += " " + chunk.filename().string();
+    }
+    const auto& cd = "cd " + remote.parent_path().string() + " && ";
+    // dd writes the joined file, as the redirection character would end the command early
+    const auto& output = session->executeCommand(cd + "cat" + parts + " | dd of=" + joined + " bs=65536; rm -f" + parts + "; cksum " + joined).get();
+    if(!session->isConnected()){
+        notifyBad("Error: telnet connection lost while joining " + remote.string());
+        removeRemoteParts();
+        return false;
+    }
+    const auto& remoteChecksum = Checksum::parseOutput(output);
+    auto itr = remoteChecksum.find(joined);
+    if(!checksum.has_value() || itr == remoteChecksum.end() || itr->second != checksum.value()){
+        notifyBad("Error: joined file " + remote.string() + " differs from " + file.string());
+        removeRemoteParts();
+        return false;
+    }
+    // replacing file keeps permissions of the file it replaces, e.g. of an executable
+    session->executeCommand(cd + "chmod --reference=" + name + " " + joined + "; mv -f " + joined + " " + name).get();
+    if(!session->isConnected()){
+        notifyBad("Error: telnet connection lost while replacing " + remote.string());
+        return false;
+    }
+    return true;
+}
+
+std::string AppModel::remoteSource()
+{
+    if(!m_telnet.source().empty()){
+        return m_telnet.source();
+    }
+    const auto& facts = m_facts.get(m_configuration.getCurrentHost());
+    return facts.has_value() ? facts->m_source : "";
+}
+
+std::optional<sf::IpAddress> AppModel::resolve(const HostData& host)
+{
+    const auto& facts = m_facts.get(host);
+    if(facts.has_value() && !facts->m_ip.empty()){
+        // dotted address, resolved without asking DNS
+        auto ip = sf::IpAddress::resolve(facts->m_ip);
+        if(ip.has_value()){
+            AddressCache::instance().seed(host.m_hostname, ip.value());
+            return ip;
         }
     }
-    return false;
+    auto ip = AddressCache::instance().resolve(host.m_hostname);
+    if(ip.has_value()){
+        HostFacts resolved;
+        resolved.m_ip = ip->toString();
+        m_facts.store(host, resolved);
+    }
+    return ip;
+}
+
+void AppModel::forgetAddress(const HostData& host)
+{
+    // address may have changed, don't trust cached ones anymore
+    m_facts.invalidate(host.m_alias);
+    AddressCache::instance().forget(host.m_hostname);
 }
 
-bool AppModel::connectToFtp(const HostData& host)
+bool AppModel::connectToFtp(const HostData& host, const bool& suppressOutput)
 {
-    auto ip = sf::IpAddress::resolve(host.m_hostname);
+    auto ip = resolve(host);
     if(!ip.has_value()){
-        notifyBad("Error: unable to resolve ip address of ftp: " + host.m_hostname);
+        if(!suppressOutput){
+            notifyBad("Error: unable to resolve ip address of ftp: " + host.m_hostname);
+        }
         return false;
     }
-    auto response = m_ftp.connect(ip.value());
-    if(response.isOk()){
-        response = m_ftp.login(host.m_username, host.m_password);
+    auto response = track(m_ftp.connect(ip.value()));
+    if(!response.isOk()){
+        forgetAddress(host);
+    } else{
+        response = track(m_ftp.login(host.m_username, host.m_password));
         if(response.isOk()){
             m_workingDir = m_ftp.getWorkingDirectory().getDirectory().string() + "/";
-            notifyGood("Success: connected via FTP to: " + host.m_alias);
+            if(!suppressOutput){
+                notifyGood("Success: connected via FTP to: " + host.m_alias);
+            }
         } else{
-            notifyBad("Error: wrong credentials when connecting via ftp to: " + host.m_alias);
+            m_ftpAlive = false; // connected, but not usable
+            if(!suppressOutput){
+                notifyBad("Error: wrong credentials when connecting via ftp to: " + host.m_alias);
+            }
         }
     }
     return response.isOk();
 }
 
-bool AppModel::connectToTelnet(const HostData& host)
+bool AppModel::connectToTelnet(const HostData& host, const bool& suppressOutput)
 {
-    notify("Connecting to telnet " + host.m_alias + "...");
-    auto ip = sf::IpAddress::resolve(host.m_hostname);
+    if(!suppressOutput){
+        notify("Connecting to telnet " + host.m_alias + "...");
+    }
+    auto ip = resolve(host);
     if(!ip.has_value()){
-        notifyBad("Error: unable to resolve ip address of telnet: " + host.m_hostname);
+        if(!suppressOutput){
+            notifyBad("Error: unable to resolve ip address of telnet: " + host.m_hostname);
+        }
         return false;
     }
     if(!m_telnet.connect(ip.value())){
-        notifyBad("Error: unable to connect via telnet to: " + host.m_alias);
+        forgetAddress(host);
+        if(!suppressOutput){
+            notifyBad("Error: unable to connect via telnet to: " + host.m_alias);
+        }
         return false;
     }
-    if(!m_telnet.login(host.m_username, host.m_password)){
-        notifyBad("Error: wrong credentials when connecting via telnet to: " + host.m_alias);
+    if(!m_telnet.login(host.m_username, host.m_password, host.m_script)){
+        m_telnet.close();
+        if(!suppressOutput){
+            notifyBad("Error: wrong credentials when connecting via telnet to: " + host.m_alias);
+        }
         return false;
     }
     if(!m_telnet.executeInitialScript(host.m_script)){
-        notifyBad("Error: when executing initial script: " + host.m_script);
+        m_telnet.close();
+        if(!suppressOutput){
+            notifyBad("Error: when executing initial script: " + host.m_script);
+        }
         return false;
     }
-    notifyGood("Success: connected via telnet to: " + host.m_alias);
+    HostFacts discovered;
+    discovered.m_source = m_telnet.source();
+    discovered.m_home = m_telnet.home();
+    discovered.m_prompt = m_telnet.prompt();
+    discovered.m_ip = ip->toString();
+    m_facts.store(host, discovered);
+    if(!suppressOutput){
+        notifyGood("Success: connected via telnet to: " + host.m_alias);
+    }
     return true;
 }
 
+void AppModel::warmup(const HostData& host, const bool& telnet)
+{
+    if(!m_ftpWarmup.valid()){
+        m_ftpWarmup = TaskExecutor::shared().submit([this, host](){
+            return isConnectedToFtp() || connectToFtp(host, true);
+        });
+    }
+    if(telnet && !m_telnetWarmup.valid() && !m_telnet.isConnected()){
+        m_telnetWarmup = TaskExecutor::shared().submit([this, host](){
+            return connectToTelnet(host, true);
+        });
+    }
+}
+
+bool AppModel::ensureFtp(const HostData& host)
+{
+    if(m_ftpWarmup.valid() && m_ftpWarmup.get()){
+        return true;
+    }
+    // when warming up failed, connecting again reports the reason
+    return isConnectedToFtp() || connectToFtp(host);
+}
+
+bool AppModel::ensureTelnet(const HostData& host)
+{
+    if(m_telnetWarmup.valid() && m_telnetWarmup.get()){
+        return true;
+    }
+    return m_telnet.isConnected() || connectToTelnet(host);
+}
+
+void AppModel::disconnect()
+{
+    // connections being warmed up have to settle before they can be closed
+    if(m_ftpWarmup.valid()){
+        m_ftpWarmup.wait();
+        m_ftpWarmup = std::future<bool>();
+    }
+    if(m_telnetWarmup.valid()){
+        m_telnetWarmup.wait();
+        m_telnetWarmup = std::future<bool>();
+    }
+    if(m_ftpAlive){
+        void(m_ftp.disconnect());
+        m_ftpAlive = false;
+    }
+    if(m_telnet.isConnected()){
+        m_telnet.close();
+    }
+}
+
 bool AppModel::isConnectedToFtp()
 {
-    return m_ftp.sendCommand("NOOP").isOk();
+    if(!m_ftpAlive){
+        return false;
+    }
+    // recent reply proves the session, only idle one may have been dropped by the server
+    if(std::chrono::steady_clock::now() - m_ftpLastReply < FTP_PROBE_AFTER){
+        return true;
+    }
+    return track(m_ftp.sendCommand("NOOP")).isOk();
 }
 
 std::pair<bool, std::string> AppModel::downloadRemoteFile(const std::filesystem::path& file, const bool& suppressOutput)
@@ -183,20 +702,34 @@ std::pair<bool, std::string> AppModel::downloadRemoteFile(const std::filesystem:
     } else{
         remote = getRemoteFileEquivalent(file.string());
     }
-    if(changeFTPDirectory(remote.parent_path())){
-        const std::string down_path = Utils::getExecutablePath() + "/temp/";
-        if(!std::filesystem::exists(down_path)){
-            std::filesystem::create_directory(down_path);
+    const std::string down_path = Utils::getExecutablePath() + "/temp/";
+    if(!std::filesystem::exists(down_path)){
+        std::filesystem::create_directory(down_path);
+    }
+    const auto& alias = m_configuration.getCurrentHost().m_alias;
+    const auto& local = down_path + remote.filename().string();
+    // SIZE and MDTM round trips are only worth it when the cache may be used
+    const auto& stat = m_cache.enabled() ? statRemote(m_ftp, remote) : std::nullopt;
+    if(stat.has_value() && m_cache.copyTo(alias, remote, stat.value(), local)){
+        if(!suppressOutput){
+            notifyGood("Success: unchanged remote file taken from cache to " + local);
         }
-        ret.first = m_ftp.download(remote, down_path, sf::Ftp::TransferMode::Ascii).isOk();
-        if(ret.first){
-            ret.second = down_path + remote.filename().string();
-            if(!suppressOutput){
-                notifyGood("Success: downloaded file to " + ret.second);
-            }
-        } else if(!suppressOutput){
-            notifyBad("Error: when downloading file " + file.string());
+        return std::make_pair(true, local);
+    }
+    ret.first = ftpRetry([&](){
+        return changeFTPDirectory(remote.parent_path()) && track(m_ftp.download(remote, down_path, sf::Ftp::TransferMode::Binary)).isOk();
+    });
+    if(ret.first){
+        localize(local);
+        ret.second = local;
+        if(stat.has_value()){
+            m_cache.put(alias, remote, stat.value(), local);
         }
+        if(!suppressOutput){
+            notifyGood("Success: downloaded file to " + ret.second);
+        }
+    } else if(!suppressOutput){
+        notifyBad("Error: when downloading file " + file.string());
     }
     return ret;
 }
@@ -216,6 +749,38 @@ bool AppModel::difftool(const std::string& first, const std::string& second)
     return last_modified != std::filesystem::last_write_time(first);
 }
 
+bool AppModel::mergeWithBase(const std::filesystem::path& remote, const std::string& local, const std::string& remoteCopy, const bool& suppressOutput)
+{
+    const auto& base = m_manifest.base(m_configuration.getCurrentHost().m_alias, remote);
+    if(!base.has_value()){
+        return false;
+    }
+    auto read = [](const std::string& path){
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    // local file is usually mapped already, when its checksum or line endings were looked at
+    const auto& mapped = m_localFiles.open(local);
+    const auto& streamed = mapped ? std::string() : read(local);
+    const auto& merged = ThreeWayMerge::merge(base.value(), mapped ? mapped->view() : std::string_view(streamed), read(remoteCopy));
+    if(!merged.m_clean){
+        if(!suppressOutput){
+            notify(std::to_string(merged.m_conflicts) + " conflicting changes in " + remote.string() + ", opening difftool");
+        }
+        return false;
+    }
+    std::ofstream file(remoteCopy, std::ios::binary | std::ios::trunc);
+    file << merged.m_text;
+    file.close();
+    if(!file.good()){
+        return false;
+    }
+    if(!suppressOutput){
+        notify("Merged " + remote.string() + " without conflicts");
+    }
+    return true;
+}
+
 bool AppModel::listChangedFiles()
 {
     if(!m_monitor.check()){
@@ -255,15 +820,15 @@ bool AppModel::listChangedFiles()
 std::pair<bool, std::string> AppModel::tlog(const std::string& filename)
 {
     auto host = m_configuration.getCurrentHost();
-    if(!m_telnet.isConnected()){
-        if(!connectToTelnet(host)){
-            return std::make_pair(false, "");
-        }
+    // FTP is needed to download the log afterwards, connect it meanwhile
+    warmup(host);
+    if(!ensureTelnet(host)){
+        return std::make_pair(false, "");
     }
 
     notify("Starts writing to file, press enter to stop...");
     
-    m_telnet.executeCommand("cd $APPDIR/../log", true, false, false);
+    m_telnet.executeCommand("cd $APPDIR/../log", true, false, false).get();
 
     auto command = "tlog > " + filename;
     notify(command);
@@ -272,11 +837,8 @@ std::pair<bool, std::string> AppModel::tlog(const std::string& filename)
     std::getline(std::cin, input);
     m_telnet.executeCommand("\x03", false, true);
 
-    if(!isConnectedToFtp()){
-        notify("Connecting via FTP in order to download file...");
-        if(!connectToFtp(host)){
-            return std::make_pair(false, "");
-        }
+    if(!ensureFtp(host)){
+        return std::make_pair(false, "");
     }
 
     auto result = downloadRemoteFile(m_telnet.pwd() + "/" + filename);
@@ -287,86 +849,345 @@ std::pair<bool, std::string> AppModel::tlog(const std::string& filename)
     return result;
 }
 
-bool AppModel::restart(const std::string& arg)
+std::vector<std::string> AppModel::restartCommands(const std::string& target)
+{
+    if(target == "env"){
+        return {"tmshutdown -y", "tmboot -y"};
+    } else if(target == "retux"){
+        return {"cd $APPDIR", "./RetuxAdapter.sh stop", "./RetuxAdapter.sh start"};
+    } else if(target.size() > 2 && tolower(target.front()) == 's' && target[1] == '-'){
+        return {"tmshutdown -s " + target.substr(2), "tmboot -s " + target.substr(2)};
+    } else if(target.size() > 2 && tolower(target.front()) == 'g' && target[1] == '-'){
+        return {"tmshutdown -g " + target.substr(2), "tmboot -g " + target.substr(2)};
+    }
+    return {};
+}
+
+std::pair<bool, std::string> AppModel::tlogStream(const std::string& filename, const std::shared_ptr<OutputFilter>& filter,
+                                                  const std::chrono::seconds& duration, const std::size_t& maxBytes)
 {
     auto host = m_configuration.getCurrentHost();
-    if(!m_telnet.isConnected()){
-        if(!connectToTelnet(host)){
-            return false;
-        }
+    auto session = m_telnetPool.acquire(host);
+    if(!session){
+        notifyBad("Error: unable to open telnet session to: " + host.m_alias);
+        return std::make_pair(false, "");
+    }
+
+    const std::string down_path = Utils::getExecutablePath() + "/temp/";
+    if(!std::filesystem::exists(down_path)){
+        std::filesystem::create_directory(down_path);
+    }
+    const std::string local = down_path + filename;
+    AsyncFileWriter writer;
+    if(!writer.open(local)){
+        notifyBad("Error: unable to open file " + local);
+        return std::make_pair(false, "");
     }
 
-    if(arg == "env"){
-        m_telnet.executeCommand("tmshutdown -y", true);
-        m_telnet.executeCommand("tmboot -y", true);
-    } else if(arg == "retux"){
-        m_telnet.executeCommand("cd $APPDIR", true);
-        m_telnet.executeCommand("./RetuxAdapter.sh stop", true);
-        m_telnet.executeCommand("./RetuxAdapter.sh start", true);
-    } else if (tolower(arg.front()) == 's' && arg[1] == '-'){
-        m_telnet.executeCommand("tmshutdown -s " + arg.substr(2), true);
-        m_telnet.executeCommand("tmboot -s " + arg.substr(2), true);
-    } else if(tolower(arg.front()) == 'g' && arg[1] == '-'){
-        m_telnet.executeCommand("tmshutdown -g " + arg.substr(2), true);
-        m_telnet.executeCommand("tmboot -g " + arg.substr(2), true);
+    std::atomic<bool> stopRequested(false);
+    std::thread enterWaiter;
+    if(duration.count() == 0 && maxBytes == 0){
+        notify("Streaming tlog to " + local + ", press enter to stop...");
+        enterWaiter = std::thread([&stopRequested](){
+            std::string input;
+            std::getline(std::cin, input);
+            stopRequested = true;
+        });
     } else{
-        notifyBad("Unknown argument: " + arg);
-        return false;
+        notify("Streaming tlog to " + local + "...");
     }
-    return true;
-}
 
-bool AppModel::script(const std::string& script)
-{
-    auto host = m_configuration.getCurrentHost();
-    if(!m_telnet.isConnected()){
-        if(!connectToTelnet(host)){
-            return false;
-        }
+    std::size_t saved = 0;
+    auto write = [&writer, &saved](const char* data, const std::size_t& size){
+        writer.write(data, size);
+        saved += size;
+    };
+    std::function<void(const char*, const std::size_t&)> save = write;
+    if(filter){
+        filter->setSink(write);
+        save = [&filter](const char* data, const std::size_t& size){
+            filter->feed(data, size);
+        };
     }
+    const auto deadline = std::chrono::steady_clock::now() + duration;
+    auto stop = [&](){
+        return stopRequested || (duration.count() != 0 && std::chrono::steady_clock::now() >= deadline) ||
+               (maxBytes != 0 && saved >= maxBytes);
+    };
 
-    notify("Executing script: " + script);
-    m_telnet.executeCommand(script, true);
-    return 0;
+    bool ret = session->stream("cd $APPDIR/../log; tlog", save, stop);
+    if(filter){
+        filter->finish();
+    }
+    if(enterWaiter.joinable()){
+        if(!stopRequested){
+            notify("Connection lost, press enter to continue...");
+        }
+        enterWaiter.join();
+    }
+    writer.close();
+    if(ret){
+        notifyGood("Success: saved " + std::to_string(writer.bytesWritten()) + " bytes to " + local);
+    } else{
+        notifyBad("Error: telnet connection lost while streaming tlog");
+    }
+    return std::make_pair(ret, local);
 }
 
-bool AppModel::transfer(const std::string& arg, const bool& useDifftool)
+bool AppModel::restart(const std::string& arg)
 {
-    auto host = m_configuration.getCurrentHost();
-    if(!isConnectedToFtp()){
-        if(!connectToFtp(host)){
+    RestartPlan plan;
+    const auto& parsed = plan.parse(arg);
+    if(!parsed.first){
+        notifyBad("Error: " + parsed.second);
+        return false;
+    }
+    for(const auto& target : plan.targets()){
+        if(restartCommands(target).empty()){
+            notifyBad("Unknown argument: " + target);
             return false;
         }
     }
 
-    if(host.m_remotePath.empty() && m_telnet.source().empty()){
-        notify("[REMOTE_PATH] is not set, retrieving source path from telnet...");
-        if(!m_telnet.isConnected()){
-            if(!connectToTelnet(host)){
-                return false;
-            }
+    auto host = m_configuration.getCurrentHost();
+    if(plan.targets().size() > 1){
+        notify("Restarting " + std::to_string(plan.targets().size()) + " targets...");
+    }
+    const auto start = std::chrono::steady_clock::now();
+    std::map<std::string, std::future<RestartResult>> running;
+    std::size_t restarted = 0;
+    bool ret = true;
+    while(!plan.done()){
+        for(const auto& target : plan.next()){
+            notify("Restarting " + target + "...");
+            running[target] = TaskExecutor::shared().submit([this, host, target](){
+                return restartTarget(host, target);
+            });
         }
-        if(m_telnet.source().empty()){
-            notifyBad("This host doesn't support transferring files, please set REMOTE_PATH in config file.");
-            return false;
-        } else{
-            notifyGood("Found path: " + m_telnet.source());
+        for(auto itr = running.begin(); itr != running.end();){
+            if(itr->second.wait_for(std::chrono::milliseconds(20)) != std::future_status::ready){
+                ++itr;
+                continue;
+            }
+            RestartResult result;
+            result.m_target = itr->first;
+            try{
+                result = itr->second.get();
+            } catch(const std::exception& e){
+                result.m_error = e.what();
+            }
+            itr = running.erase(itr);
+            if(result.m_error.empty()){
+                ++restarted;
+                notifyGood("Success: " + result.m_target + " is up (shutdown " + seconds(result.m_shutdown) + ", boot " +
+                           seconds(result.m_boot) + ", ready after " + seconds(result.m_ready) + ")");
+            } else{
+                ret = false;
+                notifyBad("Error: when restarting " + result.m_target + ": " + result.m_error);
+            }
+            for(const auto& skipped : plan.finished(result.m_target, result.m_error.empty())){
+                notifyBad("Error: " + skipped + " not restarted, it depends on " + result.m_target);
+            }
         }
     }
+    if(plan.targets().size() > 1){
+        const auto& total = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        notify("Restarted " + std::to_string(restarted) + "/" + std::to_string(plan.targets().size()) + " targets in " + seconds(total));
+    }
+    return ret;
+}
 
-    if(!m_monitor.check()){
-        notify("No files changed.");
-        return true;
+RestartResult AppModel::restartTarget(const HostData& host, const std::string& target)
+{
+    // runs on a worker thread: no notifications, everything is reported through the result
+    RestartResult result;
+    result.m_target = target;
+    auto session = m_telnetPool.acquire(host);
+    if(!session){
+        result.m_error = "unable to open telnet session to " + host.m_alias;
+        return result;
     }
+    auto elapsed = [](const std::chrono::steady_clock::time_point& since){
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - since);
+    };
 
-    if(arg == "updated" || arg == "all"){
-        for(const auto& file : m_monitor.filesUpdated()){
-            notify("Updating file: " + file.string());
-            const auto& result = updateRemoteFile(file, useDifftool);
-            if(!result.first){
-                return false;
-            }
+    // the last command boots, the ones before shut the target down
+    const auto& commands = restartCommands(target);
+    auto phase = std::chrono::steady_clock::now();
+    for(std::size_t i = 0; i < commands.size(); ++i){
+        if(i + 1 == commands.size()){
+            result.m_shutdown = elapsed(phase);
+            phase = std::chrono::steady_clock::now();
         }
+        session->executeCommand(commands[i]).get();
+        if(!session->isConnected()){
+            result.m_error = "telnet connection lost during " + commands[i];
+            return result;
+        }
+    }
+    result.m_boot = elapsed(phase);
+    phase = std::chrono::steady_clock::now();
+    if(target == "retux"){
+        return result; // adapter isn't a tuxedo server, its start script is all there is
+    }
+
+    TmadminParser parser;
+    auto capture = std::make_shared<OutputCapture>(4096, 0);
+    capture->setLineCallback([&parser](const std::string& line){
+        parser.parseLine(line);
+    });
+    while(true){
+        parser.reset();
+        session->executeCommand(TmadminParser::pollCommand(target), capture).get();
+        capture->finish();
+        if(parser.isReady(target)){
+            break;
+        }
+        if(!session->isConnected()){
+            result.m_error = "telnet connection lost while waiting for servers";
+            return result;
+        }
+        if(elapsed(phase) >= RESTART_READY_TIMEOUT){
+            result.m_error = "servers not ready after " + seconds(elapsed(phase));
+            return result;
+        }
+        std::this_thread::sleep_for(RESTART_POLL_INTERVAL);
+    }
+    result.m_ready = elapsed(phase);
+    return result;
+}
+
+std::shared_ptr<OutputCapture> AppModel::makeCapture()
+{
+    std::size_t tail = 64;
+    const auto& value = m_configuration.getValue(ConfigKey::OutputTail);
+    if(!value.empty()){
+        try{
+            tail = std::stoul(value);
+        } catch(const std::exception&){
+            notifyBad("Invalid OUTPUT_TAIL value: " + value);
+        }
+    }
+    return std::make_shared<OutputCapture>(tail * 1024);
+}
+
+std::shared_ptr<OutputFilter> AppModel::makeOutputFilter(const std::vector<std::string>& rules, const std::size_t& context)
+{
+    if(rules.empty()){
+        return nullptr;
+    }
+    auto filter = std::make_shared<OutputFilter>();
+    for(const auto& rule : rules){
+        if(!filter->addRule(rule)){
+            notifyBad("Error: invalid filter rule " + rule);
+            return nullptr;
+        }
+    }
+    filter->setContext(context, context);
+    return filter;
+}
+
+bool AppModel::script(const std::string& script, const std::string& outputLog, const std::shared_ptr<OutputFilter>& filter)
+{
+    auto host = m_configuration.getCurrentHost();
+    if(!ensureTelnet(host)){
+        return false;
+    }
+
+    auto capture = makeCapture();
+    if(!outputLog.empty() && !capture->setFileSink(outputLog)){
+        notifyBad("Error: unable to open output log " + outputLog);
+        return false;
+    }
+    BuildOutputParser parser;
+    capture->setLineCallback([&parser](const std::string& line){
+        parser.parseLine(line);
+    });
+    if(filter){
+        // output is filtered, so show what the build is doing
+        parser.setProgressCallback([this](const BuildOutputParser& parser){
+            if(!parser.currentTarget().empty()){
+                notify("[" + parser.progress() + "]");
+            }
+        });
+    }
+
+    notify("Executing script: " + script);
+    m_telnet.setOutputFilter(filter);
+    m_telnet.executeCommand(script, capture, true).get();
+    m_telnet.setOutputFilter(nullptr);
+    parser.finish();
+    if(!parser.empty()){
+        const auto& summary = parser.summary();
+        if(parser.errors()){
+            notifyBad(summary.front());
+        } else{
+            notifyGood(summary.front());
+        }
+        for(auto itr = std::next(summary.begin()); itr != summary.end(); ++itr){
+            notify(*itr);
+        }
+    } else if(!capture->errorLines().empty()){
+        notifyBad("Errors found in output:");
+        for(const auto& line : capture->errorLines()){
+            notifyBad(line);
+        }
+    }
+    if(!outputLog.empty()){
+        notify("Whole output (" + std::to_string(capture->totalBytes()) + " bytes) saved to " + outputLog);
+    }
+    return 0;
+}
+
+bool AppModel::prepareTransfer(const HostData& host)
+{
+    const bool& needsSource = host.m_remotePath.empty() && remoteSource().empty();
+    warmup(host, needsSource);
+    if(!ensureFtp(host)){
+        return false;
+    }
+
+    if(needsSource){
+        notify("[REMOTE_PATH] is not set, retrieving source path from telnet...");
+        if(!ensureTelnet(host)){
+            return false;
+        }
+        if(m_telnet.source().empty()){
+            notifyBad("This host doesn't support transferring files, please set REMOTE_PATH in config file.");
+            return false;
+        } else{
+            notifyGood("Found path: " + m_telnet.source());
+        }
+    }
+    return true;
+}
+
+bool AppModel::transfer(const std::string& arg, const bool& useDifftool)
+{
+    if(!prepareTransfer(m_configuration.getCurrentHost())){
+        return false;
+    }
+    m_rebuild.setRoot(m_configuration.getValue(ConfigKey::LocalPath));
+    m_uploaded.clear();
+    if(!m_monitor.check()){
+        notify("No files changed.");
+        return true;
+    }
+
+    if(arg == "updated" || arg == "all"){
+        prefetch(m_monitor.filesUpdated());
+        for(const auto& file : m_monitor.filesUpdated()){
+            notify("Updating file: " + file.string());
+            const auto& result = updateRemoteFile(file, useDifftool);
+            if(!result.first){
+                return false;
+            }
+            m_rebuild.add(file);
+            if(!useDifftool){
+                m_uploaded.push_back(file);
+            }
+        }
+        stopPrefetch();
     }
 
     if(arg == "added" || arg == "all"){
@@ -376,6 +1197,8 @@ bool AppModel::transfer(const std::string& arg, const bool& useDifftool)
             if(!result.first){
                 return false;
             }
+            m_rebuild.add(file);
+            m_uploaded.push_back(file);
         }
     }
     if(arg == "deleted" || arg == "all"){
@@ -385,7 +1208,994 @@ bool AppModel::transfer(const std::string& arg, const bool& useDifftool)
             if(!result.first){
                 return false;
             }
+            m_rebuild.add(file);
         }
     }
     return true;
 }
+
+bool AppModel::transfer(const std::string& arg, const std::vector<std::string>& aliases)
+{
+    if(!m_monitor.check()){
+        notify("No files changed.");
+        return true;
+    }
+    std::vector<std::filesystem::path> upload;
+    std::vector<std::filesystem::path> remove;
+    if(arg == "updated" || arg == "all"){
+        const auto& updated = m_monitor.filesUpdated();
+        upload.insert(upload.end(), updated.begin(), updated.end());
+    }
+    if(arg == "added" || arg == "all"){
+        const auto& added = m_monitor.filesAdded();
+        upload.insert(upload.end(), added.begin(), added.end());
+    }
+    if(arg == "deleted" || arg == "all"){
+        remove = m_monitor.filesRemoved();
+    }
+
+    // Resolve every alias before submitting anything: the tasks borrow upload and remove,
+    // so returning early with tasks still in flight would leave them dangling.
+    std::vector<HostData> hosts;
+    for(const auto& alias : aliases){
+        const auto& host = m_configuration.getHost(alias);
+        if(!host.has_value()){
+            notifyBad("Error: unknown host " + alias);
+            return false;
+        }
+        hosts.push_back(host.value());
+    }
+
+    notify("Sending " + std::to_string(upload.size() + remove.size()) + " files to " + std::to_string(hosts.size()) + " hosts in parallel...");
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<HostTransferResult>> transfers;
+    for(const auto& host : hosts){
+        transfers.push_back(TaskExecutor::shared().submit([this, &host, &upload, &remove](){
+            return transferToHost(host, upload, remove);
+        }));
+    }
+
+    bool ret = true;
+    for(auto& transfer : transfers){
+        const auto& result = transfer.get();
+        const auto& elapsed = std::to_string(result.m_elapsed.count()) + " ms";
+        if(result.m_errors.empty()){
+            notifyGood("Success: " + result.m_alias + ": " + std::to_string(result.m_transferred) + " files in " + elapsed);
+            continue;
+        }
+        ret = false;
+        notifyBad("Error: " + result.m_alias + ": " + std::to_string(result.m_transferred) + " files sent, " +
+                  std::to_string(result.m_errors.size()) + " failed in " + elapsed);
+        for(const auto& error : result.m_errors){
+            notifyBad("  " + error);
+        }
+    }
+    const auto& total = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    notify("All hosts done in " + std::to_string(total.count()) + " ms");
+    return ret;
+}
+
+HostTransferResult AppModel::transferToHost(const HostData& host, const std::vector<std::filesystem::path>& upload,
+                                            const std::vector<std::filesystem::path>& remove)
+{
+    // runs on a worker thread: no notifications, everything is reported through the result
+    HostTransferResult result;
+    result.m_alias = host.m_alias;
+    const auto start = std::chrono::steady_clock::now();
+    auto finish = [&result, &start](const std::string& error = ""){
+        if(!error.empty()){
+            result.m_errors.push_back(error);
+        }
+        result.m_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        return result;
+    };
+
+    std::string root = host.m_remotePath;
+    if(root.empty()){
+        const auto& facts = m_facts.get(host);
+        if(facts.has_value()){
+            root = facts->m_source;
+        }
+    }
+    if(root.empty()){
+        auto session = m_telnetPool.acquire(host);
+        if(!session){
+            return finish("unable to open telnet session to retrieve source path");
+        }
+        root = session->source();
+        HostFacts discovered;
+        discovered.m_source = session->source();
+        discovered.m_home = session->home();
+        discovered.m_prompt = session->prompt();
+        m_facts.store(host, discovered);
+    }
+    if(root.empty()){
+        return finish("source path unknown, please set REMOTE_PATH in config file");
+    }
+    if(root.back() != '/'){
+        root += '/';
+    }
+
+    const auto& ip = resolve(host);
+    if(!ip.has_value()){
+        return finish("unable to resolve ip address of " + host.m_hostname);
+    }
+    sf::Ftp ftp;
+    std::string home;
+    auto connect = [&](){
+        if(!ftp.connect(ip.value()).isOk() || !ftp.login(host.m_username, host.m_password).isOk()){
+            return false;
+        }
+        home = ftp.getWorkingDirectory().getDirectory().string();
+        return true;
+    };
+    if(!connect()){
+        forgetAddress(host);
+        return finish("unable to connect via FTP");
+    }
+    // same file is retried once on fresh connection, when the connection was lost
+    auto perform = [&](const std::function<sf::Ftp::Response()>& commands){
+        auto response = commands();
+        if(isConnectionError(response) && connect()){
+            response = commands();
+        }
+        return response.isOk();
+    };
+
+    const auto& localPath = m_configuration.getValue(ConfigKey::LocalPath);
+    for(const auto& file : upload){
+        const std::filesystem::path remote = root + file.string();
+        const auto& local = localPath + file.string();
+        const auto& copy = sendable(local);
+        const auto& sent = perform([&](){
+            auto response = changeDirectory(ftp, home, remote.parent_path());
+            return response.isOk() ? ftp.upload(copy, "", sf::Ftp::TransferMode::Binary) : response;
+        });
+        discard(copy, local);
+        if(sent){
+            m_manifest.record(host.m_alias, remote, local);
+            ++result.m_transferred;
+        } else{
+            result.m_errors.push_back("unable to upload " + file.string());
+        }
+    }
+    for(const auto& file : remove){
+        const std::filesystem::path remote = root + file.string();
+        const auto& deleted = perform([&](){
+            auto response = changeDirectory(ftp, home, remote.parent_path());
+            return response.isOk() ? ftp.deleteFile(remote.filename()) : response;
+        });
+        if(deleted){
+            m_manifest.forget(host.m_alias, remote);
+            ++result.m_transferred;
+        } else{
+            result.m_errors.push_back("unable to delete " + file.string());
+        }
+    }
+    void(ftp.disconnect());
+    return finish();
+}
+
+bool AppModel::rebuild(const std::string& command)
+{
+    for(const auto& file : m_rebuild.unbuildable()){
+        notify("No makefile above " + file.string() + ", not built");
+    }
+    if(m_rebuild.empty()){
+        notify("Nothing to rebuild.");
+        return true;
+    }
+
+    auto host = m_configuration.getCurrentHost();
+    auto waves = m_rebuild.waves();
+    for(auto& wave : waves){
+        // pool takes the builds in order, so the longest ones don't end up last
+        wave = m_buildHistory.longestFirst(host.m_alias, wave);
+    }
+    notify("Rebuilding " + std::to_string(m_rebuild.directories().size()) + " directories...");
+    const auto start = std::chrono::steady_clock::now();
+    for(std::size_t wave = 0; wave < waves.size(); ++wave){
+        std::vector<std::future<DirectoryBuildResult>> builds;
+        for(const auto& directory : waves[wave]){
+            const auto& remote = getRemoteFileEquivalent(directory);
+            builds.push_back(TaskExecutor::shared().submit([this, host, remote, command](){
+                return buildDirectory(host, remote, command);
+            }));
+        }
+        bool failed = false;
+        for(std::size_t i = 0; i < builds.size(); ++i){
+            const auto& result = builds[i].get();
+            if(result.m_built){
+                m_buildHistory.record(host.m_alias, waves[wave][i], result.m_elapsed);
+                notifyGood("Success: built " + result.m_directory.string() + " in " + seconds(result.m_elapsed));
+                continue;
+            }
+            failed = true;
+            notifyBad("Error: build of " + result.m_directory.string() + " failed: " + result.m_error);
+            for(const auto& line : result.m_summary){
+                notify(line);
+            }
+        }
+        if(failed){
+            std::size_t skipped = 0;
+            for(auto itr = waves.begin() + wave + 1; itr != waves.end(); ++itr){
+                skipped += itr->size();
+            }
+            if(skipped){
+                notifyBad("Error: " + std::to_string(skipped) + " directories above the failed build were not built");
+            }
+            return false;
+        }
+    }
+    const auto& total = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    notifyGood("Success: rebuilt " + std::to_string(m_rebuild.directories().size()) + " directories in " + seconds(total));
+    return true;
+}
+
+DirectoryBuildResult AppModel::buildDirectory(const HostData& host, const std::filesystem::path& directory, const std::string& command)
+{
+    // runs on a worker thread: no notifications, everything is reported through the result
+    DirectoryBuildResult result;
+    result.m_directory = directory;
+    auto session = m_telnetPool.acquire(host);
+    if(!session){
+        result.m_error = "unable to open telnet session to " + host.m_alias;
+        return result;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto capture = makeCapture();
+    BuildOutputParser parser;
+    int status = -1;
+    capture->setLineCallback([&parser, &status](const std::string& line){
+        auto marker = line.find(BUILD_STATUS_MARKER);
+        // the echoed command line contains the marker as well, followed by $?
+        if(marker != std::string::npos && marker + BUILD_STATUS_MARKER.size() < line.size() &&
+           std::isdigit(static_cast<unsigned char>(line[marker + BUILD_STATUS_MARKER.size()]))){
+            status = std::atoi(line.c_str() + marker + BUILD_STATUS_MARKER.size());
+            return;
+        }
+        parser.parseLine(line);
+    });
+    session->executeCommand("cd " + directory.string() + " && " + command + "; echo " + BUILD_STATUS_MARKER + "$?", capture).get();
+    capture->finish();
+    parser.finish();
+    result.m_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    result.m_built = status == 0;
+    if(status < 0){
+        result.m_error = session->isConnected() ? "exit status not received" : "telnet connection lost";
+    } else if(status > 0){
+        result.m_error = "exit status " + std::to_string(status);
+    }
+    if(!result.m_built){
+        if(parser.errors()){
+            result.m_summary = parser.summary(10);
+        } else{
+            result.m_summary = capture->errorLines();
+        }
+    }
+    return result;
+}
+
+bool AppModel::transferAndBuild(const std::string& arg, const bool& useDifftool, const std::string& command)
+{
+    auto host = m_configuration.getCurrentHost();
+    if(!prepareTransfer(host)){
+        return false;
+    }
+    m_rebuild.setRoot(m_configuration.getValue(ConfigKey::LocalPath));
+    m_uploaded.clear();
+    if(!m_monitor.check()){
+        notify("No files changed.");
+        return true;
+    }
+
+    // files grouped by the directory which builds them
+    enum class Operation{Update, Upload, Delete};
+    std::map<std::filesystem::path, std::vector<std::pair<Operation, std::filesystem::path>>> groups;
+    std::vector<std::pair<Operation, std::filesystem::path>> unbuilt;
+    auto plan = [&](const Operation& operation, const std::filesystem::path& file){
+        const auto& directory = m_rebuild.add(file);
+        if(directory.has_value()){
+            groups[directory.value()].emplace_back(operation, file);
+        } else{
+            unbuilt.emplace_back(operation, file);
+        }
+    };
+    if(arg == "updated" || arg == "all"){
+        for(const auto& file : m_monitor.filesUpdated()){
+            plan(Operation::Update, file);
+        }
+    }
+    if(arg == "added" || arg == "all"){
+        for(const auto& file : m_monitor.filesAdded()){
+            plan(Operation::Upload, file);
+        }
+    }
+    if(arg == "deleted" || arg == "all"){
+        for(const auto& file : m_monitor.filesRemoved()){
+            plan(Operation::Delete, file);
+        }
+    }
+    auto send = [&](const std::pair<Operation, std::filesystem::path>& operation){
+        const auto& file = operation.second;
+        switch(operation.first){
+            case Operation::Update:
+                notify("Updating file: " + file.string());
+                if(!updateRemoteFile(file, useDifftool).first){
+                    return false;
+                }
+                if(!useDifftool){
+                    m_uploaded.push_back(file);
+                }
+                return true;
+            case Operation::Upload:
+                notify("Uploading file: " + file.string());
+                if(!uploadAddedFile(file).first){
+                    return false;
+                }
+                m_uploaded.push_back(file);
+                return true;
+            default:
+                notify("Deleting file: " + file.string());
+                return deleteRemoteFile(file).first;
+        }
+    };
+
+    struct Build{
+        std::future<DirectoryBuildResult> m_result;
+        bool m_transferred = false;
+        bool m_started = false;
+        bool m_finished = false;
+        bool m_built = false;
+    };
+    std::vector<std::filesystem::path> directories;
+    for(const auto& group : groups){
+        directories.push_back(group.first);
+    }
+    directories = m_buildHistory.longestFirst(host.m_alias, directories);
+    std::map<std::filesystem::path, Build> builds;
+    for(const auto& directory : directories){
+        builds[directory];
+    }
+
+    bool transferred = true;
+    bool built = true;
+    // starts builds whose files landed and whose subdirectories were built, reports finished ones
+    auto progress = [&](const std::chrono::milliseconds& wait){
+        for(const auto& directory : directories){
+            auto& build = builds[directory];
+            const bool& waiting = std::any_of(builds.begin(), builds.end(), [&directory](const auto& other){
+                return RebuildPlanner::isBelow(other.first, directory) && !other.second.m_built;
+            });
+            if(transferred && build.m_transferred && !build.m_started && !waiting){
+                notify("Building " + directory.string() + "...");
+                const auto& remote = getRemoteFileEquivalent(directory);
+                build.m_result = TaskExecutor::shared().submit([this, host, remote, command](){
+                    return buildDirectory(host, remote, command);
+                });
+                build.m_started = true;
+            }
+        }
+        for(const auto& directory : directories){
+            auto& build = builds[directory];
+            if(!build.m_started || build.m_finished || build.m_result.wait_for(wait) != std::future_status::ready){
+                continue;
+            }
+            const auto& result = build.m_result.get();
+            build.m_finished = true;
+            build.m_built = result.m_built;
+            if(result.m_built){
+                m_buildHistory.record(host.m_alias, directory, result.m_elapsed);
+                notifyGood("Success: built " + result.m_directory.string() + " in " + seconds(result.m_elapsed));
+                continue;
+            }
+            built = false;
+            notifyBad("Error: build of " + result.m_directory.string() + " failed: " + result.m_error);
+            for(const auto& line : result.m_summary){
+                notify(line);
+            }
+        }
+    };
+
+    // remote versions are downloaded in the order they will be needed
+    std::vector<std::filesystem::path> updated;
+    for(const auto& directory : directories){
+        for(const auto& operation : groups[directory]){
+            if(operation.first == Operation::Update){
+                updated.push_back(operation.second);
+            }
+        }
+    }
+    for(const auto& operation : unbuilt){
+        if(operation.first == Operation::Update){
+            updated.push_back(operation.second);
+        }
+    }
+    prefetch(updated);
+
+    const auto start = std::chrono::steady_clock::now();
+    for(const auto& directory : directories){
+        for(const auto& operation : groups[directory]){
+            transferred = transferred && send(operation);
+        }
+        builds[directory].m_transferred = true;
+        progress(std::chrono::milliseconds(0));
+    }
+    for(const auto& operation : unbuilt){
+        transferred = transferred && send(operation);
+    }
+    stopPrefetch();
+    const auto& transferTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    for(const auto& file : m_rebuild.unbuildable()){
+        notify("No makefile above " + file.string() + ", not built");
+    }
+
+    auto running = [&builds](){
+        return std::any_of(builds.begin(), builds.end(), [](const auto& build){
+            return build.second.m_started && !build.second.m_finished;
+        });
+    };
+    progress(std::chrono::milliseconds(0));
+    while(running()){
+        progress(std::chrono::milliseconds(20));
+    }
+    for(const auto& directory : directories){
+        if(transferred && !builds[directory].m_started){
+            notifyBad("Error: " + directory.string() + " not built, build of its subdirectory failed");
+        }
+    }
+
+    const auto& total = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    if(!transferred){
+        notifyBad("Error: transfer failed, builds started before the failure were finished");
+    }
+    notify("Transfer took " + seconds(transferTime) + ", transfer and build " + seconds(total));
+    return transferred && built;
+}
+
+bool AppModel::transferPatch(const std::string& base)
+{
+    auto host = m_configuration.getCurrentHost();
+    if(!prepareTransfer(host)){
+        return false;
+    }
+    const auto& localPath = m_configuration.getValue(ConfigKey::LocalPath);
+    m_rebuild.setRoot(localPath);
+    m_uploaded.clear();
+    if(!m_monitor.check()){
+        notify("No files changed.");
+        return true;
+    }
+
+    const std::string down_path = Utils::getExecutablePath() + "/temp/";
+    if(!std::filesystem::exists(down_path)){
+        std::filesystem::create_directory(down_path);
+    }
+    const std::string patchName = ".remote_env_branch.patch";
+    const std::string cmd = "git -C " + localPath + " diff --binary " + base + "..HEAD > " + down_path + patchName;
+    if(system(cmd.c_str()) != 0){
+        notifyBad("Error: unable to create patch against " + base);
+        return false;
+    }
+    const auto& patchSize = std::filesystem::file_size(down_path + patchName);
+    const auto& root = getRemoteFileEquivalent("");
+    // binary mode, patch must arrive byte for byte
+    const auto& uploaded = ftpRetry([&](){
+        return changeFTPDirectory(root) && track(m_ftp.upload(down_path + patchName, "", sf::Ftp::TransferMode::Binary)).isOk();
+    });
+    std::filesystem::remove(down_path + patchName);
+    if(!uploaded){
+        notifyBad("Error: unable to send patch");
+        return false;
+    }
+
+    auto session = m_telnetPool.acquire(host);
+    if(!session){
+        notifyBad("Error: unable to open telnet session to " + host.m_alias);
+        return false;
+    }
+    notify("Applying patch of " + std::to_string(patchSize / 1024) + " KiB on " + host.m_alias + "...");
+    // rejected hunks leave .rej (and .orig from patch) files, rejected files are sent whole below anyway
+    session->executeCommand("cd " + root.string() + " && if git --version; then git apply --reject " + patchName + "; else patch -p1 -f -s -i " + patchName + "; fi;"
+                            " find . -newer " + patchName + " -name '*.rej' -exec rm -f {} +;"
+                            " find . -newer " + patchName + " -name '*.orig' -exec rm -f {} +; rm -f " + patchName).get();
+    session.release();
+
+    auto changed = m_monitor.filesUpdated();
+    const auto& added = m_monitor.filesAdded();
+    changed.insert(changed.end(), added.begin(), added.end());
+    const auto& removed = m_monitor.filesRemoved();
+    std::vector<std::future<std::optional<FileChecksum>>> local;
+    for(const auto& file : changed){
+        const auto& path = localPath + file.string();
+        local.push_back(TaskExecutor::shared().submit([this, path](){
+            return localChecksum(path);
+        }));
+    }
+    auto listed = changed;
+    listed.insert(listed.end(), removed.begin(), removed.end());
+    const auto& remote = remoteChecksums(host, listed);
+    if(!remote.has_value()){
+        for(auto& checksum : local){
+            checksum.wait();
+        }
+        return false;
+    }
+
+    std::size_t whole = 0;
+    for(std::size_t i = 0; i < changed.size(); ++i){
+        const auto& checksum = local[i].get();
+        auto itr = remote->find(changed[i].relative_path().generic_string());
+        m_rebuild.add(changed[i]);
+        m_uploaded.push_back(changed[i]);
+        if(checksum.has_value() && itr != remote->end() && itr->second == checksum.value()){
+            m_manifest.record(host.m_alias, getRemoteFileEquivalent(changed[i]), localPath + changed[i].string());
+            continue;
+        }
+        // not patched, or local file differs from HEAD
+        notify("Uploading file: " + changed[i].string());
+        if(!uploadAddedFile(changed[i]).first){
+            return false;
+        }
+        ++whole;
+    }
+    for(const auto& file : removed){
+        m_rebuild.add(file);
+        if(remote->count(file.relative_path().generic_string())){
+            notify("Deleting file: " + file.string());
+            if(!deleteRemoteFile(file).first){
+                return false;
+            }
+        } else{
+            m_manifest.forget(host.m_alias, getRemoteFileEquivalent(file));
+        }
+    }
+    notifyGood("Success: " + std::to_string(changed.size() + removed.size() - whole) + " files patched, " + std::to_string(whole) + " sent whole");
+    return true;
+}
+
+bool AppModel::verify()
+{
+    if(m_uploaded.empty()){
+        notify("Nothing to verify.");
+        return true;
+    }
+    auto host = m_configuration.getCurrentHost();
+    const auto& localPath = m_configuration.getValue(ConfigKey::LocalPath);
+    auto pending = m_uploaded;
+    for(int attempt = 0; ; ++attempt){
+        notify("Verifying " + std::to_string(pending.size()) + " files...");
+        // local checksums are computed while the remote host computes its ones
+        std::vector<std::future<std::optional<FileChecksum>>> local;
+        for(const auto& file : pending){
+            const auto& path = localPath + file.string();
+            local.push_back(TaskExecutor::shared().submit([this, path](){
+                return localChecksum(path);
+            }));
+        }
+        const auto& remote = remoteChecksums(host, pending);
+        std::vector<std::filesystem::path> mismatched;
+        for(std::size_t i = 0; i < pending.size(); ++i){
+            const auto& checksum = local[i].get();
+            if(!remote.has_value()){
+                continue;
+            }
+            auto itr = remote->find(pending[i].relative_path().generic_string());
+            if(!checksum.has_value()){
+                notifyBad("Error: unable to read " + localPath + pending[i].string());
+            } else if(itr == remote->end()){
+                notifyBad("Error: missing on remote host " + pending[i].string());
+                mismatched.push_back(pending[i]);
+            } else if(itr->second != checksum.value()){
+                notifyBad("Error: checksum mismatch " + pending[i].string());
+                mismatched.push_back(pending[i]);
+            }
+        }
+        if(!remote.has_value()){
+            return false;
+        }
+        if(mismatched.empty()){
+            notifyGood("Success: " + std::to_string(m_uploaded.size()) + " files match their remote copies");
+            return true;
+        }
+        if(attempt == VERIFY_RETRIES){
+            notifyBad("Error: " + std::to_string(mismatched.size()) + " files still differ from their remote copies");
+            return false;
+        }
+        notify("Sending " + std::to_string(mismatched.size()) + " mismatched files again...");
+        for(const auto& file : mismatched){
+            uploadAddedFile(file);
+        }
+        pending = mismatched;
+    }
+}
+
+bool AppModel::drift(const std::string& scope)
+{
+    const auto& localPath = m_configuration.getValue(ConfigKey::LocalPath);
+    std::vector<std::filesystem::path> files;
+    if(scope == "all"){
+        std::error_code error;
+        for(auto itr = std::filesystem::recursive_directory_iterator(localPath, error); !error && itr != std::filesystem::recursive_directory_iterator(); itr.increment(error)){
+            // hidden directories like .git are not sent to the host
+            if(itr->is_directory() && itr->path().filename().string().front() == '.'){
+                itr.disable_recursion_pending();
+            } else if(itr->is_regular_file()){
+                files.push_back(itr->path().lexically_relative(localPath));
+            }
+        }
+    } else if(scope == "changed"){
+        if(m_monitor.check()){
+            files = m_monitor.filesUpdated();
+        }
+    } else{
+        notifyBad("Error: unknown drift scope " + scope + ", use changed or all");
+        return false;
+    }
+    if(files.empty()){
+        notify("No files to compare.");
+        return true;
+    }
+    auto host = m_configuration.getCurrentHost();
+    if(!prepareTransfer(host)){
+        return false;
+    }
+
+    notify("Comparing " + std::to_string(files.size()) + " files with " + host.m_alias + "...");
+    std::vector<std::future<std::optional<FileChecksum>>> local;
+    for(const auto& file : files){
+        const auto& path = localPath + file.string();
+        local.push_back(TaskExecutor::shared().submit([this, path](){
+            return localChecksum(path);
+        }));
+    }
+    const auto& remote = remoteChecksums(host, files);
+    if(!remote.has_value()){
+        for(auto& checksum : local){
+            checksum.wait();
+        }
+        return false;
+    }
+
+    std::size_t same = 0;
+    std::vector<std::filesystem::path> pushed, diverged, missing;
+    for(std::size_t i = 0; i < files.size(); ++i){
+        const auto& checksum = local[i].get();
+        auto itr = remote->find(files[i].relative_path().generic_string());
+        if(!checksum.has_value()){
+            notifyBad("Error: unable to read " + localPath + files[i].string());
+        } else if(itr == remote->end()){
+            missing.push_back(files[i]);
+        } else if(itr->second == checksum.value()){
+            ++same;
+        } else{
+            const auto& base = m_manifest.base(host.m_alias, getRemoteFileEquivalent(files[i]));
+            Checksum last(localKind(localPath + files[i].string()) == FileKind::Text);
+            if(base.has_value()){
+                last.update(base->data(), base->size());
+            }
+            if(base.has_value() && last.finish() == itr->second){
+                pushed.push_back(files[i]);
+            } else{
+                diverged.push_back(files[i]);
+            }
+        }
+    }
+
+    // diverged copies download over separate sessions while the diffs are printed
+    prefetch(diverged);
+    notifyGood(std::to_string(same) + " files equal their remote copies");
+    if(!pushed.empty()){
+        notify("CHANGED LOCALLY SINCE LAST PUSH:");
+        for(const auto& file : pushed){
+            notify(file.string());
+        }
+    }
+    if(!missing.empty()){
+        notifyBad("MISSING ON REMOTE HOST:");
+        for(const auto& file : missing){
+            notifyBad(file.string());
+        }
+    }
+    if(!diverged.empty()){
+        notifyBad("DIVERGED:");
+    }
+    auto read = [](const std::filesystem::path& path){
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    bool ret = true;
+    for(const auto& file : diverged){
+        const auto& remoteFile = getRemoteFileEquivalent(file);
+        auto copy = m_prefetcher.take(remoteFile);
+        if(!copy.has_value()){
+            const auto& downloaded = downloadRemoteFile(file, true);
+            if(downloaded.first){
+                copy = downloaded.second;
+            }
+        }
+        if(!copy.has_value()){
+            notifyBad("Error: unable to download " + remoteFile.string());
+            ret = false;
+            continue;
+        }
+        const auto& mapped = m_localFiles.open(localPath + file.string());
+        const auto& streamed = mapped ? std::string() : read(localPath + file.string());
+        notify(UnifiedDiff::render(read(copy.value()), mapped ? mapped->view() : std::string_view(streamed), remoteFile.string(), localPath + file.string()));
+        std::filesystem::remove(copy.value());
+    }
+    stopPrefetch();
+    return ret;
+}
+
+bool AppModel::pull(const std::function<bool(const std::string&, const std::vector<std::filesystem::path>&)>& confirm)
+{
+    auto host = m_configuration.getCurrentHost();
+    if(!prepareTransfer(host)){
+        return false;
+    }
+    auto session = m_telnetPool.acquire(host);
+    if(!session){
+        notifyBad("Error: unable to open telnet session to " + host.m_alias);
+        return false;
+    }
+    const auto& root = getRemoteFileEquivalent("");
+    notify("Computing checksums of remote files in " + root.string() + "...");
+    // '>' would end the command early, file names containing it can't be pulled anyway
+    const auto& output = session->executeCommand("cd " + root.string() + " && find . -path '*/.*' -prune -o -type f -exec cksum {} + | tr -d '\\076'").get();
+    if(!session->isConnected()){
+        notifyBad("Error: telnet connection lost while computing checksums");
+        return false;
+    }
+    const auto& remote = Checksum::parseOutput(output);
+
+    const auto& localPath = m_configuration.getValue(ConfigKey::LocalPath);
+    // files deleted locally but not pushed yet aren't new, the next push deletes them remotely
+    m_monitor.check();
+    const auto& removed = m_monitor.filesRemoved();
+    const std::set<std::filesystem::path> deleted(removed.begin(), removed.end());
+    std::vector<std::filesystem::path> files, missing;
+    std::vector<FileChecksum> expected;
+    std::vector<std::future<std::optional<FileChecksum>>> local;
+    for(const auto& entry : remote){
+        const std::filesystem::path file = entry.first.rfind("./", 0) == 0 ? entry.first.substr(2) : entry.first;
+        const auto& path = localPath + file.string();
+        if(!std::filesystem::exists(path)){
+            // leftovers of rejected patch hunks
+            if(!deleted.count(file) && file.extension() != ".rej" && file.extension() != ".orig"){
+                missing.push_back(file);
+            }
+            continue;
+        }
+        files.push_back(file);
+        expected.push_back(entry.second);
+        local.push_back(TaskExecutor::shared().submit([this, path](){
+            return localChecksum(path);
+        }));
+    }
+    // build outputs and other files git ignores stay on the remote host
+    missing = notIgnored(missing);
+    std::vector<std::filesystem::path> changed;
+    for(std::size_t i = 0; i < files.size(); ++i){
+        const auto& checksum = local[i].get();
+        if(!checksum.has_value() || checksum.value() != expected[i]){
+            changed.push_back(files[i]);
+        }
+    }
+    if(changed.empty() && missing.empty()){
+        notifyGood("Success: " + std::to_string(remote.size()) + " remote files equal local ones");
+        return true;
+    }
+
+    if(!missing.empty()){
+        notifyGood("NEW:");
+        for(const auto& file : missing){
+            notifyGood(file.string());
+        }
+    }
+    if(!changed.empty()){
+        notifyGood("CHANGED:");
+        for(const auto& file : changed){
+            notifyGood(file.string());
+        }
+    }
+    std::vector<std::filesystem::path> pulled;
+    if(!missing.empty() && confirm("Create " + std::to_string(missing.size()) + " new local files?", missing)){
+        pulled = missing;
+    }
+    if(!changed.empty() && confirm("Overwrite " + std::to_string(changed.size()) + " changed local files?", changed)){
+        pulled.insert(pulled.end(), changed.begin(), changed.end());
+    }
+    if(pulled.empty()){
+        return true;
+    }
+
+    // mapped files can't be replaced on every system
+    m_localFiles.clear();
+    notify("Pulling " + std::to_string(pulled.size()) + " files...");
+    prefetch(pulled);
+    std::size_t failed = 0;
+    for(const auto& file : pulled){
+        const auto& remoteFile = getRemoteFileEquivalent(file);
+        auto copy = m_prefetcher.take(remoteFile);
+        if(!copy.has_value()){
+            const auto& downloaded = downloadRemoteFile(file, true);
+            if(downloaded.first){
+                copy = downloaded.second;
+            }
+        }
+        const std::filesystem::path destination = localPath + file.string();
+        std::error_code error;
+        if(copy.has_value()){
+            std::filesystem::create_directories(destination.parent_path(), error);
+            std::filesystem::rename(copy.value(), destination, error);
+            if(error){
+                // prefetched copy may be on another filesystem
+                error.clear();
+                std::filesystem::copy_file(copy.value(), destination, std::filesystem::copy_options::overwrite_existing, error);
+                std::filesystem::remove(copy.value());
+            }
+        }
+        if(!copy.has_value() || error){
+            notifyBad("Error: unable to pull " + remoteFile.string());
+            ++failed;
+            continue;
+        }
+        // remote content is now the base of both sides
+        m_manifest.record(host.m_alias, remoteFile, destination);
+    }
+    stopPrefetch();
+    if(failed){
+        notifyBad("Error: " + std::to_string(failed) + " files were not pulled");
+        return false;
+    }
+    notifyGood("Success: pulled " + std::to_string(pulled.size()) + " files into " + localPath + ", review them with git diff");
+    return true;
+}
+
+std::optional<std::map<std::string, FileChecksum>> AppModel::remoteChecksums(const HostData& host, const std::vector<std::filesystem::path>& files)
+{
+    // paths go to the remote host as a file, so the command stays one short line however many files there are
+    const std::string down_path = Utils::getExecutablePath() + "/temp/";
+    if(!std::filesystem::exists(down_path)){
+        std::filesystem::create_directory(down_path);
+    }
+    const std::string listName = ".remote_env_verify.txt";
+    {
+        std::ofstream list(down_path + listName, std::ios::binary);
+        for(const auto& file : files){
+            list << file.relative_path().generic_string() << '\n';
+        }
+        if(!list){
+            notifyBad("Error: unable to write " + down_path + listName);
+            return std::nullopt;
+        }
+    }
+    const auto& root = getRemoteFileEquivalent("");
+    const auto& uploaded = ensureFtp(host) && ftpRetry([&](){
+        return changeFTPDirectory(root) && track(m_ftp.upload(down_path + listName, "", sf::Ftp::TransferMode::Binary)).isOk();
+    });
+    std::filesystem::remove(down_path + listName);
+    if(!uploaded){
+        notifyBad("Error: unable to send list of files to verify");
+        return std::nullopt;
+    }
+
+    auto session = m_telnetPool.acquire(host);
+    if(!session){
+        notifyBad("Error: unable to open telnet session to " + host.m_alias);
+        return std::nullopt;
+    }
+    // one path per line, read whole, as xargs would split paths containing spaces or quotes
+    const auto& output = session->executeCommand("cd " + root.string() + " && cat " + listName + " | while IFS= read -r f; do cksum \"$f\"; done; rm -f " + listName).get();
+    if(!session->isConnected()){
+        notifyBad("Error: telnet connection lost while computing checksums");
+        return std::nullopt;
+    }
+    return Checksum::parseOutput(output);
+}
+
+std::vector<std::filesystem::path> AppModel::notIgnored(const std::vector<std::filesystem::path>& files) const
+{
+    if(files.empty()){
+        return files;
+    }
+    const std::string down_path = Utils::getExecutablePath() + "/temp/";
+    if(!std::filesystem::exists(down_path)){
+        std::filesystem::create_directory(down_path);
+    }
+    const std::string listName = ".remote_env_pull.txt";
+    const std::string ignoredName = ".remote_env_ignored.txt";
+    {
+        // NUL separated, names may contain spaces or newlines
+        std::ofstream list(down_path + listName, std::ios::binary);
+        for(const auto& file : files){
+            list << file.generic_string() << '\0';
+        }
+    }
+    // exits with 1 when nothing is ignored, output tells everything needed
+    const std::string cmd = "git -C " + m_configuration.getValue(ConfigKey::LocalPath) + " check-ignore -z --stdin < " +
+                            down_path + listName + " > " + down_path + ignoredName;
+    system(cmd.c_str());
+    std::set<std::string> ignored;
+    {
+        std::ifstream output(down_path + ignoredName, std::ios::binary);
+        std::string path;
+        while(std::getline(output, path, '\0')){
+            ignored.insert(path);
+        }
+    }
+    std::filesystem::remove(down_path + listName);
+    std::filesystem::remove(down_path + ignoredName);
+
+    std::vector<std::filesystem::path> ret;
+    for(const auto& file : files){
+        if(!ignored.count(file.generic_string())){
+            ret.push_back(file);
+        }
+    }
+    return ret;
+}
+
+void AppModel::prefetch(const std::vector<std::filesystem::path>& files)
+{
+    if(files.empty()){
+        return;
+    }
+    std::vector<std::filesystem::path> remotes;
+    for(const auto& file : files){
+        remotes.push_back(getRemoteFileEquivalent(file));
+    }
+    auto host = m_configuration.getCurrentHost();
+    m_prefetcher.start([this, host](){
+        // every worker gets its own FTP session, connected on first download
+        auto ftp = std::make_shared<sf::Ftp>();
+        auto home = std::make_shared<std::string>();
+        auto connected = std::make_shared<bool>(false);
+        return [this, host, ftp, home, connected](const std::filesystem::path& remote, const std::filesystem::path& directory){
+            auto connect = [&](){
+                const auto& ip = resolve(host);
+                *connected = ip.has_value() && ftp->connect(ip.value()).isOk() && ftp->login(host.m_username, host.m_password).isOk();
+                if(*connected){
+                    *home = ftp->getWorkingDirectory().getDirectory().string();
+                }
+                return *connected;
+            };
+            if(!*connected && !connect()){
+                return false;
+            }
+            const auto& local = directory / remote.filename();
+            const auto& stat = m_cache.enabled() ? statRemote(*ftp, remote) : std::nullopt;
+            if(stat.has_value() && m_cache.copyTo(host.m_alias, remote, stat.value(), local)){
+                return true;
+            }
+            auto download = [&](){
+                auto response = changeDirectory(*ftp, *home, remote.parent_path());
+                return response.isOk() ? ftp->download(remote.filename(), directory, sf::Ftp::TransferMode::Binary) : response;
+            };
+            auto response = download();
+            if(isConnectionError(response) && connect()){
+                response = download();
+            }
+            if(response.isOk()){
+                localize(local);
+            }
+            if(response.isOk() && stat.has_value()){
+                m_cache.put(host.m_alias, remote, stat.value(), local);
+            }
+            return response.isOk();
+        };
+    }, remotes);
+}
+
+void AppModel::stopPrefetch()
+{
+    m_prefetcher.cancel();
+}
+
+void AppModel::releaseLocalFiles()
+{
+    m_localFiles.clear();
+}
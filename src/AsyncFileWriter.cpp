@@ -0,0 +1,72 @@
+#include "AsyncFileWriter.hpp"
+
+AsyncFileWriter::AsyncFileWriter(const std::size_t& bufferSize) : m_bufferSize(bufferSize), m_closing(false), m_written(0)
+{
+
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    close();
+}
+
+bool AsyncFileWriter::open(const std::filesystem::path& path)
+{
+    close();
+    m_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!m_file.is_open()){
+        return false;
+    }
+    m_front.reserve(m_bufferSize);
+    m_back.reserve(m_bufferSize);
+    m_closing = false;
+    m_written = 0;
+    m_thread = std::thread(&AsyncFileWriter::run, this);
+    return true;
+}
+
+void AsyncFileWriter::write(const char* data, const std::size_t& size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_front.append(data, size);
+    if(m_front.size() >= m_bufferSize){
+        m_ready.notify_one();
+    }
+}
+
+void AsyncFileWriter::close()
+{
+    if(!m_thread.joinable()){
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closing = true;
+    }
+    m_ready.notify_one();
+    m_thread.join();
+    m_file.close();
+}
+
+void AsyncFileWriter::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(true){
+        m_ready.wait_for(lock, std::chrono::milliseconds(500), [this](){
+            return m_closing || m_front.size() >= m_bufferSize;
+        });
+        const bool closing = m_closing;
+        m_back.swap(m_front);
+        lock.unlock();
+        if(!m_back.empty()){
+            m_file.write(m_back.data(), m_back.size());
+            m_file.flush();
+            m_written += m_back.size();
+            m_back.clear();
+        }
+        if(closing){
+            return;
+        }
+        lock.lock();
+    }
+}
@@ -0,0 +1,96 @@
+#include "BuildHistory.hpp"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+BuildHistory::BuildHistory(const std::string& path) : m_path(path)
+{
+    readFile();
+}
+
+std::optional<std::chrono::milliseconds> BuildHistory::estimate(const std::string& alias, const std::filesystem::path& directory) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto itr = m_times.find(std::make_pair(alias, directory.generic_string()));
+    if(itr == m_times.end()){
+        return std::nullopt;
+    }
+    return itr->second;
+}
+
+void BuildHistory::record(const std::string& alias, const std::filesystem::path& directory, const std::chrono::milliseconds& elapsed)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto itr = m_times.find(std::make_pair(alias, directory.generic_string()));
+        if(itr == m_times.end()){
+            m_times[std::make_pair(alias, directory.generic_string())] = elapsed;
+        } else{
+            // one unusual build (e.g. full rebuild after header change) shouldn't reorder everything
+            itr->second = (itr->second + elapsed) / 2;
+        }
+    }
+    saveFile();
+}
+
+std::vector<std::filesystem::path> BuildHistory::longestFirst(const std::string& alias, std::vector<std::filesystem::path> directories) const
+{
+    std::map<std::filesystem::path, std::chrono::milliseconds> expected;
+    std::chrono::milliseconds known(0);
+    std::size_t count = 0;
+    for(const auto& directory : directories){
+        const auto& time = estimate(alias, directory);
+        if(time.has_value()){
+            expected[directory] = time.value();
+            known += time.value();
+            ++count;
+        }
+    }
+    const std::chrono::milliseconds average(count ? known.count() / static_cast<long long>(count) : 0);
+    for(const auto& directory : directories){
+        expected.emplace(directory, average);
+    }
+    std::stable_sort(directories.begin(), directories.end(), [&expected](const std::filesystem::path& first, const std::filesystem::path& second){
+        return expected[first] > expected[second];
+    });
+    return directories;
+}
+
+bool BuildHistory::readFile()
+{
+    std::ifstream file(m_path);
+    if(!file) return false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_times.clear();
+    std::string line;
+    while(std::getline(file, line)){
+        if(line.empty()) continue;
+        std::istringstream ss(line);
+        std::string alias;
+        long long elapsed = 0;
+        if(!(ss >> alias >> elapsed)){
+            std::cerr << "Malformed line in build history: " << line << std::endl;
+            continue;
+        }
+        // directory may contain spaces and is empty for the root of sources
+        std::string directory;
+        std::getline(ss, directory);
+        if(!directory.empty() && directory.front() == ' '){
+            directory.erase(0, 1);
+        }
+        m_times[std::make_pair(alias, directory)] = std::chrono::milliseconds(elapsed);
+    }
+    return true;
+}
+
+bool BuildHistory::saveFile()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::ofstream file(m_path);
+    if(!file) return false;
+    for(const auto& pair : m_times){
+        file << pair.first.first << ' ' << pair.second.count() << ' ' << pair.first.second << '\n';
+    }
+    return true;
+}
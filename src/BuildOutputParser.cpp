@@ -0,0 +1,221 @@
+#include "BuildOutputParser.hpp"
+#include <sstream>
+#include <iomanip>
+#include <cctype>
+
+// diagnostics above that are only counted, so a broken build can't grow memory without limits
+static const std::size_t MAX_DIAGNOSTICS = 1000;
+
+static bool startsWith(const std::string& str, const std::string& prefix)
+{
+    return str.compare(0, prefix.size(), prefix) == 0;
+}
+
+static std::string trim(const std::string& str, const char* characters = " \t\r\n")
+{
+    auto begin = str.find_first_not_of(characters);
+    if(begin == std::string::npos){
+        return "";
+    }
+    return str.substr(begin, str.find_last_not_of(characters) - begin + 1);
+}
+
+static std::string seconds(const std::chrono::milliseconds& elapsed)
+{
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1) << elapsed.count() / 1000.0 << " s";
+    return ss.str();
+}
+
+// splits "file:line[:col]" prefix, line stays 0 if there is no number
+static void splitLocation(const std::string& location, BuildDiagnostic& diagnostic)
+{
+    auto colon = location.find(':');
+    diagnostic.m_file = location.substr(0, colon);
+    if(colon != std::string::npos){
+        std::size_t index = colon + 1;
+        int number = 0;
+        while(index < location.size() && std::isdigit(static_cast<unsigned char>(location[index]))){
+            number = number * 10 + (location[index++] - '0');
+        }
+        diagnostic.m_line = number;
+    }
+}
+
+BuildOutputParser::BuildOutputParser() : m_start(Clock::now()), m_errors(0), m_warnings(0)
+{
+
+}
+
+void BuildOutputParser::parseLine(const std::string& line)
+{
+    static const std::string making = "making target";
+    auto index = line.find(making);
+    if(index != std::string::npos){
+        startTarget(trim(line.substr(index + making.size()), " \t\r\n'\"`:."));
+        return;
+    }
+    // cheap check first, most of the lines are neither diagnostics nor linker output
+    if(line.find(':') == std::string::npos){
+        return;
+    }
+    if(!parseLinker(line) && !parseXlc(line)){
+        parseGcc(line);
+    }
+}
+
+void BuildOutputParser::finish()
+{
+    closeTarget(Clock::now());
+}
+
+std::string BuildOutputParser::progress() const
+{
+    std::string ret = "targets: " + std::to_string(m_targets.size() + (m_current.empty() ? 0 : 1)) +
+                      ", errors: " + std::to_string(m_errors) + ", warnings: " + std::to_string(m_warnings);
+    if(!m_current.empty()){
+        ret += ", building: " + m_current;
+    }
+    return ret;
+}
+
+std::vector<std::string> BuildOutputParser::summary(const std::size_t& maxDiagnostics) const
+{
+    std::vector<std::string> ret;
+    const auto& total = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - m_start);
+    ret.push_back("Build summary: " + std::to_string(m_targets.size()) + " targets, " + std::to_string(m_errors) + " errors, " +
+                  std::to_string(m_warnings) + " warnings in " + seconds(total));
+    for(const auto& target : m_targets){
+        ret.push_back("  " + target.m_name + " - " + seconds(target.m_elapsed));
+    }
+    std::size_t listed = 0;
+    for(const bool& errors : {true, false}){
+        for(const auto& diagnostic : m_diagnostics){
+            if(diagnostic.m_error != errors || listed >= maxDiagnostics){
+                continue;
+            }
+            std::string location = diagnostic.m_file;
+            if(diagnostic.m_line){
+                location += ":" + std::to_string(diagnostic.m_line);
+            }
+            ret.push_back(std::string(errors ? (diagnostic.m_linker ? "  link error " : "  error ") : "  warning ") +
+                          location + ": " + diagnostic.m_message + (diagnostic.m_target.empty() ? "" : " [" + diagnostic.m_target + "]"));
+            ++listed;
+        }
+    }
+    if(listed < m_errors + m_warnings){
+        ret.push_back("  ... and " + std::to_string(m_errors + m_warnings - listed) + " more");
+    }
+    return ret;
+}
+
+void BuildOutputParser::startTarget(const std::string& name)
+{
+    closeTarget(Clock::now());
+    m_current = name;
+    m_currentStart = Clock::now();
+    if(m_progressCallback){
+        m_progressCallback(*this);
+    }
+}
+
+void BuildOutputParser::closeTarget(const Clock::time_point& now)
+{
+    if(!m_current.empty()){
+        m_targets.push_back({m_current, std::chrono::duration_cast<std::chrono::milliseconds>(now - m_currentStart)});
+        m_current.clear();
+    }
+}
+
+bool BuildOutputParser::parseLinker(const std::string& line)
+{
+    const bool undefined = line.find("undefined reference to") != std::string::npos || line.find("Undefined symbol") != std::string::npos;
+    const bool linker = startsWith(line, "ld:") || startsWith(line, "collect2:") || line.find("/ld:") != std::string::npos;
+    if(!undefined && !linker){
+        return false;
+    }
+    if(line.find("ld returned") != std::string::npos){
+        // only a consequence of errors already reported, unless the linker said nothing else
+        const bool reported = !m_diagnostics.empty() && m_diagnostics.back().m_linker && m_diagnostics.back().m_target == m_current;
+        if(reported){
+            return true;
+        }
+    } else if(!undefined && line.find("rror") == std::string::npos && line.find("fatal") == std::string::npos){
+        return false; // linker warnings and notes are not failures
+    }
+    BuildDiagnostic diagnostic;
+    diagnostic.m_linker = true;
+    if(!linker){
+        splitLocation(line.substr(0, line.find(": ")), diagnostic);
+    } else{
+        diagnostic.m_file = line.substr(0, line.find(':'));
+    }
+    diagnostic.m_message = trim(line.substr(line.find(": ") + 1));
+    addDiagnostic(diagnostic);
+    return true;
+}
+
+bool BuildOutputParser::parseGcc(const std::string& line)
+{
+    static const std::pair<std::string, bool> kinds[] = {{": fatal error: ", true}, {": error: ", true}, {": warning: ", false}};
+    std::size_t position = std::string::npos, length = 0;
+    bool error = true;
+    for(const auto& kind : kinds){
+        auto found = line.find(kind.first);
+        if(found < position){
+            position = found;
+            length = kind.first.size();
+            error = kind.second;
+        }
+    }
+    if(position == std::string::npos){
+        return false;
+    }
+    BuildDiagnostic diagnostic;
+    splitLocation(line.substr(0, position), diagnostic);
+    diagnostic.m_error = error;
+    diagnostic.m_message = line.substr(position + length);
+    addDiagnostic(diagnostic);
+    return true;
+}
+
+bool BuildOutputParser::parseXlc(const std::string& line)
+{
+    if(line.empty() || line.front() != '"'){
+        return false;
+    }
+    auto quote = line.find("\", line ");
+    if(quote == std::string::npos){
+        return false;
+    }
+    BuildDiagnostic diagnostic;
+    diagnostic.m_file = line.substr(1, quote - 1);
+    std::size_t index = quote + 8;
+    while(index < line.size() && std::isdigit(static_cast<unsigned char>(line[index]))){
+        diagnostic.m_line = diagnostic.m_line * 10 + (line[index++] - '0');
+    }
+    auto severity = line.find(" (", index);
+    if(severity == std::string::npos || severity + 3 >= line.size() || line[severity + 3] != ')'){
+        return false;
+    }
+    switch(line[severity + 2]){
+        case 'U': case 'S': case 'E': diagnostic.m_error = true; break;
+        case 'W': diagnostic.m_error = false; break;
+        default: return true; // informational
+    }
+    diagnostic.m_message = trim(line.substr(line.find(": ", index) + 1));
+    addDiagnostic(diagnostic);
+    return true;
+}
+
+void BuildOutputParser::addDiagnostic(BuildDiagnostic diagnostic)
+{
+    diagnostic.m_error ? ++m_errors : ++m_warnings;
+    diagnostic.m_target = m_current;
+    if(m_diagnostics.size() < MAX_DIAGNOSTICS){
+        m_diagnostics.push_back(std::move(diagnostic));
+    }
+    if(m_progressCallback){
+        m_progressCallback(*this);
+    }
+}
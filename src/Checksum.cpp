@@ -0,0 +1,126 @@
+#include "Checksum.hpp"
+#include <array>
+#include <fstream>
+#include <sstream>
+
+static std::array<uint32_t, 256> makeTable()
+{
+    // CRC-32 with polynomial 0x04C11DB7, most significant bit first, as in POSIX cksum
+    std::array<uint32_t, 256> table{};
+    for(uint32_t i = 0; i < table.size(); ++i){
+        uint32_t crc = i << 24;
+        for(int bit = 0; bit < 8; ++bit){
+            crc = (crc & 0x80000000u) ? (crc << 1) ^ 0x04C11DB7u : crc << 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+static const std::array<uint32_t, 256> CRC_TABLE = makeTable();
+
+Checksum::Checksum(const bool& normalizeCrlf) : m_crc(0), m_size(0), m_normalizeCrlf(normalizeCrlf), m_pendingCr(false)
+{
+
+}
+
+void Checksum::update(const char* data, const std::size_t& size)
+{
+    if(!m_normalizeCrlf){
+        crc(data, size);
+        return;
+    }
+    // CR is held back until the next byte shows whether it ends a CRLF
+    std::size_t begin = 0;
+    if(m_pendingCr && size){
+        m_pendingCr = false;
+        if(data[0] != '\n'){
+            crc("\r", 1);
+        }
+    }
+    for(std::size_t i = 0; i < size; ++i){
+        if(data[i] != '\r'){
+            continue;
+        }
+        crc(data + begin, i - begin);
+        begin = i + 1;
+        if(i + 1 == size){
+            m_pendingCr = true;
+        } else if(data[i + 1] != '\n'){
+            crc("\r", 1);
+        }
+    }
+    crc(data + begin, size - begin);
+}
+
+FileChecksum Checksum::finish()
+{
+    if(m_pendingCr){
+        m_pendingCr = false;
+        crc("\r", 1);
+    }
+    // length is appended least significant byte first, without trailing zero bytes
+    uint32_t ret = m_crc;
+    for(uint64_t length = m_size; length; length >>= 8){
+        ret = (ret << 8) ^ CRC_TABLE[((ret >> 24) ^ length) & 0xFF];
+    }
+    return {~ret, m_size};
+}
+
+void Checksum::crc(const char* data, const std::size_t& size)
+{
+    for(std::size_t i = 0; i < size; ++i){
+        m_crc = (m_crc << 8) ^ CRC_TABLE[((m_crc >> 24) ^ static_cast<unsigned char>(data[i])) & 0xFF];
+    }
+    m_size += size;
+}
+
+std::optional<FileChecksum> Checksum::ofFile(const std::filesystem::path& path, const bool& normalizeCrlf)
+{
+    std::ifstream file(path, std::ios::binary);
+    if(!file){
+        return std::nullopt;
+    }
+    Checksum checksum(normalizeCrlf);
+    std::vector<char> buffer(64 * 1024);
+    while(file){
+        file.read(buffer.data(), buffer.size());
+        checksum.update(buffer.data(), static_cast<std::size_t>(file.gcount()));
+    }
+    if(file.bad()){
+        return std::nullopt;
+    }
+    return checksum.finish();
+}
+
+FileChecksum Checksum::ofData(std::string_view data, const bool& normalizeCrlf)
+{
+    Checksum checksum(normalizeCrlf);
+    checksum.update(data.data(), data.size());
+    return checksum.finish();
+}
+
+std::map<std::string, FileChecksum> Checksum::parseOutput(const std::string& output)
+{
+    std::map<std::string, FileChecksum> ret;
+    std::istringstream lines(output);
+    std::string line;
+    while(std::getline(lines, line)){
+        if(!line.empty() && line.back() == '\r'){
+            line.pop_back();
+        }
+        std::istringstream ss(line);
+        std::string crc, size, path;
+        // path is the rest of the line after the single separating space, it may contain spaces itself
+        if(!(ss >> crc >> size) || ss.get() != ' ' || !std::getline(ss, path) || path.empty() ||
+           crc.find_first_not_of("0123456789") != std::string::npos || size.find_first_not_of("0123456789") != std::string::npos){
+            continue;
+        }
+        try{
+            ret[path] = {static_cast<uint32_t>(std::stoul(crc)), std::stoull(size)};
+        } catch(const std::exception&){
+            continue;
+        }
+    }
+    return ret;
+}
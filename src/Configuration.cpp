@@ -2,6 +2,7 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 
 Configuration::Configuration(const std::string& path) : m_configFile(path), m_save(false)
 {
@@ -116,6 +117,63 @@ const HostData& Configuration::getCurrentHost() const
     return itr->second;
 }
 
+std::optional<HostData> Configuration::getHost(const std::string& alias) const
+{
+    auto itr = m_hosts.find(alias);
+    if(itr == m_hosts.end())
+        return std::nullopt;
+    return itr->second;
+}
+
+bool Configuration::addGroup(const std::string& name, const std::vector<std::string>& hosts)
+{
+    if(hosts.empty() || m_groups.count(name) || m_hosts.count(name))
+        return false;
+    for(const auto& host : hosts){
+        if(m_hosts.find(host) == m_hosts.end())
+            return false;
+    }
+    m_groups.emplace(name, hosts);
+    m_save = true;
+    return true;
+}
+
+std::vector<std::string> Configuration::getGroup(const std::string& name) const
+{
+    auto itr = m_groups.find(name);
+    if(itr != m_groups.end())
+        return itr->second;
+    return {};
+}
+
+std::vector<std::string> Configuration::expandHosts(const std::string& names) const
+{
+    std::vector<std::string> aliases;
+    auto add = [&aliases](const std::string& alias){
+        if(std::find(aliases.begin(), aliases.end(), alias) == aliases.end())
+            aliases.push_back(alias);
+    };
+    std::istringstream stream(names);
+    for(std::string name; std::getline(stream, name, ',');){
+        if(name.empty()) continue;
+        if(m_hosts.count(name)){
+            add(name);
+        } else if(m_groups.count(name)){
+            for(const auto& alias : m_groups.at(name)){
+                if(!m_hosts.count(alias)){
+                    std::cerr << "No such host as: " << alias << " in group " << name << std::endl;
+                    return {};
+                }
+                add(alias);
+            }
+        } else{
+            std::cerr << "No such host or group as: " << name << std::endl;
+            return {};
+        }
+    }
+    return aliases;
+}
+
 bool Configuration::readFile()
 {
     std::ifstream file(m_configFile);
@@ -130,6 +188,19 @@ bool Configuration::readFile()
             std::cerr << "Malformed line in config: " << line << std::endl;
             continue;
         }
+        if(string_key == "GROUP:"){
+            // GROUP: name alias1,alias2,...
+            std::string hosts;
+            iss >> hosts;
+            auto& group = m_groups[value];
+            group.clear();
+            std::istringstream hostsStream(hosts);
+            for(std::string host; std::getline(hostsStream, host, ',');){
+                if(!host.empty())
+                    group.push_back(host);
+            }
+            continue;
+        }
         auto key = stringToKey(string_key);
         if(key != ConfigKey::None){
             // Handling config data
@@ -180,6 +251,14 @@ bool Configuration::saveFile()
     for (const auto& pair : m_configData)
         file << keyToString(pair.first) << " " << pair.second << '\n';
     file << '\n';
+    for(const auto& group : m_groups){
+        file << "GROUP: " << group.first << " ";
+        for(std::size_t i = 0; i < group.second.size(); ++i)
+            file << (i ? "," : "") << group.second[i];
+        file << '\n';
+    }
+    if(!m_groups.empty())
+        file << '\n';
     for(const auto& pair : m_hosts)
         file << keyToString(HostConfig::Alias) << " " << pair.first << '\n' 
              << keyToString(HostConfig::HostName) << " " << pair.second.m_hostname << '\n'
@@ -218,7 +297,13 @@ std::string Configuration::keyToString(const ConfigKey& key)
     {ConfigKey::DefaultHost, "DEFAULT_HOST:"},
     {ConfigKey::LocalPath, "LOCAL_PATH:"},
     {ConfigKey::DifftoolSide, "DIFFTOOL_SIDE:"},
-    {ConfigKey::Difftool, "DIFFTOOL:"}};
+    {ConfigKey::Difftool, "DIFFTOOL:"},
+    {ConfigKey::TelnetSessions, "TELNET_SESSIONS:"},
+    {ConfigKey::OutputTail, "OUTPUT_TAIL:"},
+    {ConfigKey::FactsTtl, "FACTS_TTL:"},
+    {ConfigKey::CacheSize, "CACHE_SIZE:"},
+    {ConfigKey::ChunkThreshold, "CHUNK_THRESHOLD:"},
+    {ConfigKey::BinaryFiles, "BINARY_FILES:"}};
     auto itr = map.find(key);
     return itr->second;
 }
@@ -229,7 +314,13 @@ ConfigKey Configuration::stringToKey(const std::string& key)
     {"DEFAULT_HOST:", ConfigKey::DefaultHost},
     {"LOCAL_PATH:", ConfigKey::LocalPath},
     {"DIFFTOOL_SIDE:", ConfigKey::DifftoolSide},
-    {"DIFFTOOL:", ConfigKey::Difftool}};
+    {"DIFFTOOL:", ConfigKey::Difftool},
+    {"TELNET_SESSIONS:", ConfigKey::TelnetSessions},
+    {"OUTPUT_TAIL:", ConfigKey::OutputTail},
+    {"FACTS_TTL:", ConfigKey::FactsTtl},
+    {"CACHE_SIZE:", ConfigKey::CacheSize},
+    {"CHUNK_THRESHOLD:", ConfigKey::ChunkThreshold},
+    {"BINARY_FILES:", ConfigKey::BinaryFiles}};
     auto itr = map.find(key);
     if(itr != map.end())
         return itr->second;
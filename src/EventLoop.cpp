@@ -0,0 +1,97 @@
+#include "EventLoop.hpp"
+
+EventLoop& EventLoop::instance()
+{
+    static EventLoop loop;
+    return loop;
+}
+
+EventLoop::EventLoop() : m_nextId(0), m_requested(0), m_applied(0), m_running(true)
+{
+    m_thread = std::thread(&EventLoop::run, this);
+}
+
+EventLoop::~EventLoop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_changed.notify_all();
+    m_thread.join();
+}
+
+std::size_t EventLoop::add(sf::Socket& socket, const Handler& onReadable, const Handler& onTick)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const std::size_t id = ++m_nextId;
+    m_added.push_back({id, {&socket, onReadable, onTick}});
+    ++m_requested;
+    m_changed.notify_all();
+    return id;
+}
+
+void EventLoop::remove(const std::size_t& id)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_removed.push_back(id);
+    const std::size_t request = ++m_requested;
+    m_changed.notify_all();
+    if(!isLoopThread()){
+        // changes are applied between iterations, after that the handlers are never called again
+        m_changed.wait(lock, [this, request](){
+            return m_applied >= request || !m_running;
+        });
+    }
+}
+
+void EventLoop::applyChanges()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(auto& added : m_added){
+        m_selector.add(*added.second.m_socket);
+        m_entries.emplace(added.first, std::move(added.second));
+    }
+    m_added.clear();
+    for(const auto& id : m_removed){
+        auto itr = m_entries.find(id);
+        if(itr != m_entries.end()){
+            m_selector.remove(*itr->second.m_socket);
+            m_entries.erase(itr);
+        }
+    }
+    m_removed.clear();
+    m_applied = m_requested;
+    m_changed.notify_all();
+}
+
+void EventLoop::run()
+{
+    while(true){
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            // nothing to serve, sleep until something gets registered
+            m_changed.wait(lock, [this](){
+                return !m_running || !m_entries.empty() || !m_added.empty() || m_applied != m_requested;
+            });
+            if(!m_running){
+                return;
+            }
+        }
+        applyChanges();
+        if(m_entries.empty()){
+            continue;
+        }
+
+        if(m_selector.wait(sf::milliseconds(20))){
+            for(auto& entry : m_entries){
+                if(m_selector.isReady(*entry.second.m_socket)){
+                    entry.second.m_onReadable();
+                }
+            }
+        }
+        for(auto& entry : m_entries){
+            entry.second.m_onTick();
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#include "FileChunker.hpp"
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+
+// how far past the requested size a newline is looked for
+static const std::size_t NEWLINE_WINDOW = 64 * 1024;
+
+// end of the chunk starting at data, where available bytes are at hand
+static std::size_t chunkEnd(const char* data, const std::size_t& available, const uint64_t& chunkSize)
+{
+    if(available <= chunkSize){
+        return available;
+    }
+    const auto& newline = static_cast<const char*>(std::memchr(data + chunkSize - 1, '\n', available - chunkSize + 1));
+    return newline ? newline - data + 1 : chunkSize;
+}
+
+static bool writeChunk(const char* data, const std::size_t& size, const std::string& name, const std::filesystem::path& directory,
+                       std::vector<std::filesystem::path>& chunks)
+{
+    std::ostringstream part;
+    part << name << ".part" << std::setw(3) << std::setfill('0') << chunks.size();
+    const auto& path = directory / part.str();
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    output.write(data, size);
+    if(!output){
+        return false;
+    }
+    chunks.push_back(path);
+    return true;
+}
+
+std::vector<std::filesystem::path> FileChunker::split(const std::filesystem::path& file, const std::filesystem::path& directory,
+                                                      const uint64_t& chunkSize)
+{
+    std::vector<std::filesystem::path> ret;
+    std::ifstream input(file, std::ios::binary);
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if(!input.is_open() || chunkSize == 0 || error){
+        return ret;
+    }
+    std::vector<char> buffer(chunkSize + NEWLINE_WINDOW);
+    // bytes read past the end of previous chunk
+    std::size_t carried = 0;
+    while(true){
+        input.read(buffer.data() + carried, buffer.size() - carried);
+        const std::size_t available = carried + static_cast<std::size_t>(input.gcount());
+        if(available == 0){
+            break;
+        }
+        const auto& end = chunkEnd(buffer.data(), available, chunkSize);
+        if(!writeChunk(buffer.data(), end, file.filename().string(), directory, ret)){
+            ret.clear();
+            return ret;
+        }
+        carried = available - end;
+        std::copy(buffer.begin() + end, buffer.begin() + available, buffer.begin());
+        if(input.eof() && carried == 0){
+            break;
+        }
+        input.clear();
+    }
+    return ret;
+}
+
+std::vector<std::filesystem::path> FileChunker::split(std::string_view content, const std::string& name, const std::filesystem::path& directory,
+                                                      const uint64_t& chunkSize)
+{
+    std::vector<std::filesystem::path> ret;
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if(chunkSize == 0 || error){
+        return ret;
+    }
+    while(!content.empty()){
+        // same boundaries as streaming the file
+        const auto& end = chunkEnd(content.data(), std::min<std::size_t>(content.size(), chunkSize + NEWLINE_WINDOW), chunkSize);
+        if(!writeChunk(content.data(), end, name, directory, ret)){
+            ret.clear();
+            return ret;
+        }
+        content.remove_prefix(end);
+    }
+    return ret;
+}
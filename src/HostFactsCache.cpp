@@ -0,0 +1,130 @@
+#include "HostFactsCache.hpp"
+#include <fstream>
+#include <iostream>
+
+HostFactsCache::HostFactsCache(const std::string& path, const std::chrono::hours& ttl) : m_path(path), m_ttl(ttl)
+{
+    readFile();
+}
+
+std::optional<HostFacts> HostFactsCache::get(const HostData& host) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto itr = m_entries.find(host.m_alias);
+    if(itr == m_entries.end() || !isValid(itr->second, host)){
+        return std::nullopt;
+    }
+    return itr->second.m_facts;
+}
+
+void HostFactsCache::store(const HostData& host, const HostFacts& facts)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& entry = m_entries[host.m_alias];
+        if(!isValid(entry, host)){
+            entry.m_facts = HostFacts();
+        }
+        entry.m_hostname = host.m_hostname;
+        entry.m_username = host.m_username;
+        entry.m_script = host.m_script;
+        for(auto field : {&HostFacts::m_source, &HostFacts::m_home, &HostFacts::m_prompt, &HostFacts::m_ip}){
+            if(!(facts.*field).empty()){
+                entry.m_facts.*field = facts.*field;
+            }
+        }
+        entry.m_facts.m_updated = std::chrono::system_clock::now();
+    }
+    saveFile();
+}
+
+void HostFactsCache::invalidate(const std::string& alias)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_entries.erase(alias) == 0){
+            return;
+        }
+    }
+    saveFile();
+}
+
+void HostFactsCache::setTtl(const std::chrono::hours& ttl)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ttl = ttl;
+}
+
+bool HostFactsCache::isValid(const Entry& entry, const HostData& host) const
+{
+    // facts come from the environment set up by the script, for other user or script they differ
+    if(entry.m_hostname != host.m_hostname || entry.m_username != host.m_username || entry.m_script != host.m_script){
+        return false;
+    }
+    return std::chrono::system_clock::now() - entry.m_facts.m_updated < m_ttl;
+}
+
+bool HostFactsCache::readFile()
+{
+    std::ifstream file(m_path);
+    if(!file) return false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    Entry* current = nullptr;
+    std::string line;
+    while(std::getline(file, line)){
+        if(line.empty()) continue;
+        const auto& separator = line.find(' ');
+        const auto& key = line.substr(0, separator);
+        // values like prompt may contain spaces, so value is the rest of the line
+        const auto& value = separator == std::string::npos ? "" : line.substr(separator + 1);
+        if(key == "ALIAS:"){
+            current = &m_entries[value];
+        } else if(current == nullptr){
+            std::cerr << "[ALIAS] field must come before any other host fact!" << std::endl;
+        } else if(key == "HOST:"){
+            current->m_hostname = value;
+        } else if(key == "USERNAME:"){
+            current->m_username = value;
+        } else if(key == "SCRIPT:"){
+            current->m_script = value;
+        } else if(key == "SOURCE:"){
+            current->m_facts.m_source = value;
+        } else if(key == "HOME:"){
+            current->m_facts.m_home = value;
+        } else if(key == "PROMPT:"){
+            current->m_facts.m_prompt = value;
+        } else if(key == "IP:"){
+            current->m_facts.m_ip = value;
+        } else if(key == "UPDATED:"){
+            try{
+                current->m_facts.m_updated = std::chrono::system_clock::time_point(std::chrono::seconds(std::stoll(value)));
+            } catch(const std::exception&){
+                std::cerr << "Malformed line in host facts: " << line << std::endl;
+            }
+        } else{
+            std::cerr << "No such host fact as: " << key << std::endl;
+        }
+    }
+    return true;
+}
+
+bool HostFactsCache::saveFile()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::ofstream file(m_path);
+    if(!file) return false;
+    for(const auto& pair : m_entries){
+        const auto& updated = std::chrono::duration_cast<std::chrono::seconds>(pair.second.m_facts.m_updated.time_since_epoch());
+        file << "ALIAS: " << pair.first << '\n'
+             << "HOST: " << pair.second.m_hostname << '\n'
+             << "USERNAME: " << pair.second.m_username << '\n'
+             << "SCRIPT: " << pair.second.m_script << '\n'
+             << "SOURCE: " << pair.second.m_facts.m_source << '\n'
+             << "HOME: " << pair.second.m_facts.m_home << '\n'
+             << "PROMPT: " << pair.second.m_facts.m_prompt << '\n'
+             << "IP: " << pair.second.m_facts.m_ip << '\n'
+             << "UPDATED: " << updated.count() << "\n\n";
+    }
+    return true;
+}
@@ -0,0 +1,194 @@
+#include "LineEndings.hpp"
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <cstring>
+#include <fstream>
+
+// block sniffed for NUL bytes, the same as git looks at
+static const std::size_t SNIFF_SIZE = 8000;
+static const std::size_t BLOCK_SIZE = 1024 * 1024;
+
+LineEndings::LineEndings(const std::string& binaryPatterns)
+{
+    std::vector<std::string> patterns;
+    boost::split(patterns, binaryPatterns, boost::is_any_of(", "), boost::token_compress_on);
+    for(const auto& pattern : patterns){
+        if(!pattern.empty()){
+            m_binaryPatterns.push_back(pattern);
+        }
+    }
+}
+
+FileKind LineEndings::kind(const std::filesystem::path& file) const
+{
+    if(matchesPattern(file)){
+        return FileKind::Binary;
+    }
+    std::ifstream input(file, std::ios::binary);
+    char block[SNIFF_SIZE];
+    input.read(block, sizeof(block));
+    return isBinary(block, static_cast<std::size_t>(input.gcount())) ? FileKind::Binary : FileKind::Text;
+}
+
+FileKind LineEndings::kind(const std::filesystem::path& file, std::string_view content) const
+{
+    return matchesPattern(file) || isBinary(content.data(), content.size()) ? FileKind::Binary : FileKind::Text;
+}
+
+bool LineEndings::matchesPattern(const std::filesystem::path& file) const
+{
+    const auto& name = file.filename().string();
+    for(const auto& pattern : m_binaryPatterns){
+        if(matches(pattern, name)){
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LineEndings::isBinary(const char* data, const std::size_t& size)
+{
+    return std::memchr(data, '\0', std::min(size, SNIFF_SIZE)) != nullptr;
+}
+
+bool LineEndings::matches(const std::string& pattern, const std::string& name)
+{
+    // greedy matching with backtracking to the last star
+    std::size_t p = 0, n = 0, star = std::string::npos, mark = 0;
+    while(n < name.size()){
+        if(p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])){
+            ++p;
+            ++n;
+        } else if(p < pattern.size() && pattern[p] == '*'){
+            star = p++;
+            mark = n;
+        } else if(star != std::string::npos){
+            p = star + 1;
+            n = ++mark;
+        } else{
+            return false;
+        }
+    }
+    while(p < pattern.size() && pattern[p] == '*'){
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+// converts one block of a file, lastCr carries a CR ending previous block
+static std::string convertBlock(std::string_view current, bool& lastCr, const bool& crlf)
+{
+    std::string converted;
+    if(crlf){
+        converted = LineEndings::toCrlf(current);
+        if(lastCr && current.front() == '\n'){
+            converted.erase(0, 1);
+        }
+        lastCr = current.back() == '\r';
+        return converted;
+    }
+    // CR held back from previous block is dropped only when LF follows
+    if(lastCr && current.front() != '\n'){
+        converted.push_back('\r');
+    }
+    lastCr = current.back() == '\r';
+    if(lastCr){
+        current.remove_suffix(1);
+    }
+    converted += LineEndings::toLf(current);
+    return converted;
+}
+
+bool LineEndings::convert(const std::filesystem::path& from, const std::filesystem::path& to, const bool& crlf)
+{
+    std::ifstream input(from, std::ios::binary);
+    std::ofstream output(to, std::ios::binary | std::ios::trunc);
+    if(!input.is_open() || !output.is_open()){
+        return false;
+    }
+    std::string block(BLOCK_SIZE, '\0');
+    bool lastCr = false;
+    while(input.read(block.data(), block.size()) || input.gcount() > 0){
+        const auto& converted = convertBlock(std::string_view(block.data(), static_cast<std::size_t>(input.gcount())), lastCr, crlf);
+        output.write(converted.data(), converted.size());
+    }
+    if(lastCr && !crlf){
+        output.put('\r');
+    }
+    return output.good();
+}
+
+bool LineEndings::convertContent(std::string_view content, const std::filesystem::path& to, const bool& crlf)
+{
+    std::ofstream output(to, std::ios::binary | std::ios::trunc);
+    if(!output.is_open()){
+        return false;
+    }
+    bool lastCr = false;
+    while(!content.empty()){
+        const auto& block = content.substr(0, BLOCK_SIZE);
+        const auto& converted = convertBlock(block, lastCr, crlf);
+        output.write(converted.data(), converted.size());
+        content.remove_prefix(block.size());
+    }
+    if(lastCr && !crlf){
+        output.put('\r');
+    }
+    return output.good();
+}
+
+bool LineEndings::hasCr(const std::filesystem::path& file)
+{
+    std::ifstream input(file, std::ios::binary);
+    std::string block(BLOCK_SIZE, '\0');
+    while(input){
+        input.read(block.data(), block.size());
+        if(std::memchr(block.data(), '\r', static_cast<std::size_t>(input.gcount()))){
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string LineEndings::toLf(std::string_view text)
+{
+    std::string ret;
+    ret.reserve(text.size());
+    while(!text.empty()){
+        const auto* cr = static_cast<const char*>(std::memchr(text.data(), '\r', text.size()));
+        if(!cr){
+            ret.append(text);
+            break;
+        }
+        const std::size_t index = cr - text.data();
+        ret.append(text.data(), index);
+        // lone CR is not a line ending, keep it
+        if(index + 1 >= text.size() || text[index + 1] != '\n'){
+            ret.push_back('\r');
+        }
+        text.remove_prefix(index + 1);
+    }
+    return ret;
+}
+
+std::string LineEndings::toCrlf(std::string_view text)
+{
+    std::string ret;
+    ret.reserve(text.size() + text.size() / 32);
+    std::size_t begin = 0;
+    while(begin < text.size()){
+        const auto* lf = static_cast<const char*>(std::memchr(text.data() + begin, '\n', text.size() - begin));
+        if(!lf){
+            ret.append(text.data() + begin, text.size() - begin);
+            break;
+        }
+        const std::size_t index = lf - text.data();
+        ret.append(text.data() + begin, index - begin);
+        if(index == 0 || text[index - 1] != '\r'){
+            ret.push_back('\r');
+        }
+        ret.push_back('\n');
+        begin = index + 1;
+    }
+    return ret;
+}
@@ -0,0 +1,121 @@
+#include "LocalFileReader.hpp"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path& path) : m_data(nullptr), m_size(0), m_valid(false)
+{
+#ifdef _WIN32
+    m_mapping = nullptr;
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if(file == INVALID_HANDLE_VALUE){
+        return;
+    }
+    LARGE_INTEGER size;
+    if(GetFileSizeEx(file, &size)){
+        m_size = static_cast<std::size_t>(size.QuadPart);
+        // empty file can't be mapped, but its view is valid
+        m_valid = m_size == 0;
+        if(m_size){
+            m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if(m_mapping){
+                m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+                m_valid = m_data != nullptr;
+            }
+        }
+    }
+    CloseHandle(file);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0){
+        return;
+    }
+    struct stat info;
+    if(fstat(fd, &info) == 0){
+        m_size = static_cast<std::size_t>(info.st_size);
+        m_valid = m_size == 0;
+        if(m_size){
+            void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(data != MAP_FAILED){
+                // all consumers scan from the beginning to the end
+                madvise(data, m_size, MADV_SEQUENTIAL);
+                m_data = static_cast<const char*>(data);
+                m_valid = true;
+            }
+        }
+    }
+    ::close(fd);
+#endif
+    if(!m_valid){
+        m_size = 0;
+    }
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if(m_data){
+        UnmapViewOfFile(m_data);
+    }
+    if(m_mapping){
+        CloseHandle(m_mapping);
+    }
+#else
+    if(m_data){
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+#endif
+}
+
+LocalFileReader::LocalFileReader(const uint64_t& limit) : m_limit(limit), m_mappings(0)
+{
+
+}
+
+std::shared_ptr<const MappedFile> LocalFileReader::open(const std::filesystem::path& file)
+{
+    std::error_code error;
+    const auto& size = std::filesystem::file_size(file, error);
+    const auto& modified = std::filesystem::last_write_time(file, error);
+    if(error || size > m_limit){
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& entry = m_entries[file];
+    if(entry.m_file && entry.m_size == size && entry.m_modified == modified){
+        return entry.m_file;
+    }
+    auto mapped = std::make_shared<const MappedFile>(file);
+    if(!mapped->isValid()){
+        m_entries.erase(file);
+        return nullptr;
+    }
+    ++m_mappings;
+    entry.m_file = mapped;
+    entry.m_size = size;
+    entry.m_modified = modified;
+    return mapped;
+}
+
+void LocalFileReader::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
+
+void LocalFileReader::release(const std::filesystem::path& file)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.erase(file);
+}
+
+std::size_t LocalFileReader::mappings() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_mappings;
+}
@@ -0,0 +1,107 @@
+#include "OutputCapture.hpp"
+#include <cstring>
+#include <algorithm>
+#include <cctype>
+
+// lines longer than that are cut, so a stream without new lines can't grow the line buffer
+static const std::size_t MAX_LINE_LENGTH = 4096;
+
+OutputCapture::OutputCapture(const std::size_t& tailSize, const std::size_t& maxErrorLines) :
+m_ring(std::max<std::size_t>(tailSize, 1)), m_head(0), m_filled(0), m_totalBytes(0), m_maxErrorLines(maxErrorLines)
+{
+
+}
+
+bool OutputCapture::setFileSink(const std::filesystem::path& path)
+{
+    m_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    return m_file.is_open();
+}
+
+void OutputCapture::append(const char* data, const std::size_t& size)
+{
+    m_totalBytes += size;
+    if(m_file.is_open()){
+        m_file.write(data, size);
+    }
+    writeTail(data, size);
+
+    if(!m_lineCallback && m_errorLines.size() >= m_maxErrorLines){
+        return; // nobody is interested in lines anymore
+    }
+    const char* end = data + size;
+    while(data < end){
+        const char* newLine = static_cast<const char*>(std::memchr(data, '\n', end - data));
+        const char* lineEnd = newLine ? newLine : end;
+        if(m_line.size() < MAX_LINE_LENGTH){
+            m_line.append(data, std::min<std::size_t>(lineEnd - data, MAX_LINE_LENGTH - m_line.size()));
+        }
+        if(!newLine){
+            break;
+        }
+        processLine();
+        data = newLine + 1;
+    }
+}
+
+void OutputCapture::finish()
+{
+    if(!m_line.empty()){
+        processLine();
+    }
+    if(m_file.is_open()){
+        m_file.flush();
+    }
+}
+
+std::string OutputCapture::tail() const
+{
+    std::string ret;
+    ret.reserve(m_filled);
+    const std::size_t start = (m_head + m_ring.size() - m_filled) % m_ring.size();
+    const std::size_t first = std::min(m_filled, m_ring.size() - start);
+    ret.append(m_ring.data() + start, first);
+    ret.append(m_ring.data(), m_filled - first);
+    return ret;
+}
+
+bool OutputCapture::isErrorLine(const std::string& line)
+{
+    static const char* keys[] = {"error", "fatal", "failed", "undefined reference", "cannot"};
+    std::string lower(line);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c){ return std::tolower(c); });
+    return std::any_of(std::begin(keys), std::end(keys), [&lower](const char* key){
+        return lower.find(key) != std::string::npos;
+    });
+}
+
+void OutputCapture::writeTail(const char* data, std::size_t size)
+{
+    const std::size_t capacity = m_ring.size();
+    if(size >= capacity){
+        // only the last capacity bytes survive anyway
+        std::memcpy(m_ring.data(), data + size - capacity, capacity);
+        m_head = 0;
+        m_filled = capacity;
+        return;
+    }
+    const std::size_t first = std::min(size, capacity - m_head);
+    std::memcpy(m_ring.data() + m_head, data, first);
+    std::memcpy(m_ring.data(), data + first, size - first);
+    m_head = (m_head + size) % capacity;
+    m_filled = std::min(m_filled + size, capacity);
+}
+
+void OutputCapture::processLine()
+{
+    if(!m_line.empty() && m_line.back() == '\r'){
+        m_line.pop_back();
+    }
+    if(m_errorLines.size() < m_maxErrorLines && isErrorLine(m_line)){
+        m_errorLines.push_back(m_line);
+    }
+    if(m_lineCallback){
+        m_lineCallback(m_line);
+    }
+    m_line.clear();
+}
@@ -0,0 +1,251 @@
+#include "OutputFilter.hpp"
+#include <cstring>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define OUTPUT_FILTER_SSE2
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// an unterminated line longer than that is cut, so a stream without new lines can't grow it
+static const std::size_t MAX_PENDING = 64 * 1024;
+
+#ifdef OUTPUT_FILTER_SSE2
+static unsigned lowestBit(unsigned mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+OutputFilter::OutputFilter(const Sink& sink) : m_sink(sink), m_beforeStart(0), m_beforeCount(0), m_afterContext(0), m_afterLeft(0)
+{
+
+}
+
+bool OutputFilter::addRule(const std::string& rule)
+{
+    bool exclude = !rule.empty() && rule.front() == '!';
+    std::string pattern = exclude ? rule.substr(1) : rule;
+    if(pattern.empty()){
+        return false;
+    }
+    if(pattern.size() > 2 && pattern.front() == '/' && pattern.back() == '/'){
+        try{
+            std::regex regex(pattern.substr(1, pattern.size() - 2), std::regex::ECMAScript | std::regex::optimize);
+            (exclude ? m_excludeRegex : m_includeRegex).push_back(std::move(regex));
+        } catch(const std::regex_error&){
+            return false;
+        }
+    } else{
+        (exclude ? m_exclude : m_include).push_back(pattern);
+    }
+    return true;
+}
+
+void OutputFilter::setContext(const std::size_t& before, const std::size_t& after)
+{
+    m_before.assign(before, std::string());
+    m_beforeStart = m_beforeCount = 0;
+    m_afterContext = after;
+    m_afterLeft = 0;
+}
+
+void OutputFilter::feed(const char* data, const std::size_t& size)
+{
+    if(empty()){
+        if(m_sink){
+            m_sink(data, size);
+        }
+        return;
+    }
+    const char* end = data + size;
+    if(!m_pending.empty()){
+        const char* newLine = static_cast<const char*>(std::memchr(data, '\n', size));
+        if(!newLine){
+            m_pending.append(data, std::min(size, MAX_PENDING - std::min(MAX_PENDING, m_pending.size())));
+            return;
+        }
+        m_pending.append(data, newLine + 1);
+        const char* pendingEnd = m_pending.data() + m_pending.size();
+        filterLine(m_pending.data(), pendingEnd, keywordIn(m_pending.data(), pendingEnd));
+        m_pending.clear();
+        data = newLine + 1;
+    }
+
+    const char* lastNewLine = end;
+    while(lastNewLine != data && *(lastNewLine - 1) != '\n'){
+        --lastNewLine;
+    }
+    filterLines(data, lastNewLine);
+    m_pending.assign(lastNewLine, std::min<std::size_t>(end - lastNewLine, MAX_PENDING));
+}
+
+void OutputFilter::finish()
+{
+    if(!m_pending.empty()){
+        const char* pendingEnd = m_pending.data() + m_pending.size();
+        filterLine(m_pending.data(), pendingEnd, keywordIn(m_pending.data(), pendingEnd));
+        m_pending.clear();
+    }
+}
+
+const char* OutputFilter::findLiteral(const char* begin, const char* end, const std::string& needle)
+{
+    const std::size_t length = needle.size();
+    if(length == 0){
+        return begin;
+    }
+    if(end - begin < static_cast<std::ptrdiff_t>(length)){
+        return nullptr;
+    }
+    if(length == 1){
+        return static_cast<const char*>(std::memchr(begin, needle.front(), end - begin));
+    }
+    const char* limit = end - length + 1; // last possible start is limit - 1
+    const char* pos = begin;
+#ifdef OUTPUT_FILTER_SSE2
+    // compare first and last byte of the needle at 16 positions at once, only full candidates go to memcmp
+    const __m128i first = _mm_set1_epi8(needle.front());
+    const __m128i last = _mm_set1_epi8(needle.back());
+    for(; pos + 16 <= limit; pos += 16){
+        const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos + length - 1));
+        unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last)));
+        while(mask){
+            const unsigned bit = lowestBit(mask);
+            if(std::memcmp(pos + bit + 1, needle.data() + 1, length - 2) == 0){
+                return pos + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+    while(pos < limit){
+        pos = static_cast<const char*>(std::memchr(pos, needle.front(), limit - pos));
+        if(!pos){
+            return nullptr;
+        }
+        if(std::memcmp(pos, needle.data(), length) == 0){
+            return pos;
+        }
+        ++pos;
+    }
+    return nullptr;
+}
+
+void OutputFilter::filterLines(const char* begin, const char* end)
+{
+    // lines which can't match are only skipped when nothing but literals decides
+    const bool skipping = !m_include.empty() && m_includeRegex.empty();
+    const char* keyword = nullptr;
+    const char* line = begin;
+    while(line < end){
+        if(!m_include.empty() && (keyword == nullptr || keyword < line)){
+            keyword = end;
+            for(const auto& include : m_include){
+                // only occurrences starting before the best one so far are interesting
+                const char* bound = end - keyword > static_cast<std::ptrdiff_t>(include.size()) ? keyword + include.size() - 1 : end;
+                const char* found = findLiteral(line, bound, include);
+                if(found && found < keyword){
+                    keyword = found;
+                }
+            }
+        }
+
+        if(skipping && m_afterLeft == 0 && keyword >= line){
+            const char* keywordLine = keyword;
+            while(keywordLine > line && *(keywordLine - 1) != '\n'){
+                --keywordLine;
+            }
+            // step back to keep lines needed as context before the match
+            const char* resume = keywordLine;
+            for(std::size_t i = 0; i < m_before.size() && resume > line; ++i){
+                --resume;
+                while(resume > line && *(resume - 1) != '\n'){
+                    --resume;
+                }
+            }
+            if(resume > line){
+                m_beforeStart = m_beforeCount = 0; // skipped lines are newer than the remembered ones
+                line = resume;
+                if(line >= end){
+                    break;
+                }
+            }
+        }
+
+        const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        lineEnd = lineEnd ? lineEnd + 1 : end;
+        filterLine(line, lineEnd, !m_include.empty() && keyword < lineEnd);
+        line = lineEnd;
+    }
+}
+
+void OutputFilter::filterLine(const char* begin, const char* end, const bool& keywordFound)
+{
+    const char* textEnd = end;
+    while(textEnd > begin && (*(textEnd - 1) == '\n' || *(textEnd - 1) == '\r')){
+        --textEnd;
+    }
+    bool keep = keywordFound || (m_include.empty() && m_includeRegex.empty());
+    if(!keep){
+        keep = std::any_of(m_includeRegex.begin(), m_includeRegex.end(), [begin, textEnd](const std::regex& regex){
+            return std::regex_search(begin, textEnd, regex);
+        });
+    }
+    if(keep && excluded(begin, textEnd)){
+        keep = false;
+    }
+
+    if(keep){
+        for(std::size_t i = 0; i < m_beforeCount; ++i){
+            const auto& context = m_before[(m_beforeStart + i) % m_before.size()];
+            emit(context.data(), context.data() + context.size());
+        }
+        m_beforeStart = m_beforeCount = 0;
+        emit(begin, end);
+        m_afterLeft = m_afterContext;
+    } else if(m_afterLeft > 0){
+        emit(begin, end);
+        --m_afterLeft;
+    } else if(!m_before.empty()){
+        if(m_beforeCount < m_before.size()){
+            m_before[(m_beforeStart + m_beforeCount++) % m_before.size()].assign(begin, end);
+        } else{
+            m_before[m_beforeStart].assign(begin, end);
+            m_beforeStart = (m_beforeStart + 1) % m_before.size();
+        }
+    }
+}
+
+bool OutputFilter::keywordIn(const char* begin, const char* end) const
+{
+    return std::any_of(m_include.begin(), m_include.end(), [begin, end](const std::string& include){
+        return findLiteral(begin, end, include) != nullptr;
+    });
+}
+
+bool OutputFilter::excluded(const char* begin, const char* end) const
+{
+    return std::any_of(m_exclude.begin(), m_exclude.end(), [begin, end](const std::string& exclude){
+        return findLiteral(begin, end, exclude) != nullptr;
+    }) || std::any_of(m_excludeRegex.begin(), m_excludeRegex.end(), [begin, end](const std::regex& regex){
+        return std::regex_search(begin, end, regex);
+    });
+}
+
+void OutputFilter::emit(const char* begin, const char* end)
+{
+    if(m_sink){
+        m_sink(begin, end - begin);
+    }
+}
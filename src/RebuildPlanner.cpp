@@ -0,0 +1,83 @@
+#include "RebuildPlanner.hpp"
+
+RebuildPlanner::RebuildPlanner(const std::filesystem::path& localRoot) : m_root(localRoot)
+{
+
+}
+
+void RebuildPlanner::setRoot(const std::filesystem::path& localRoot)
+{
+    m_root = localRoot;
+    clear();
+}
+
+void RebuildPlanner::clear()
+{
+    m_directories.clear();
+    m_unbuildable.clear();
+    m_makefiles.clear();
+}
+
+std::optional<std::filesystem::path> RebuildPlanner::add(const std::filesystem::path& file)
+{
+    auto directory = file.relative_path().parent_path();
+    while(true){
+        if(hasMakefile(directory)){
+            m_directories.insert(directory);
+            return directory;
+        }
+        if(directory.empty()){
+            break;
+        }
+        directory = directory.parent_path();
+    }
+    m_unbuildable.push_back(file);
+    return std::nullopt;
+}
+
+std::vector<std::vector<std::filesystem::path>> RebuildPlanner::waves() const
+{
+    std::map<std::size_t, std::vector<std::filesystem::path>, std::greater<std::size_t>> depths;
+    for(const auto& directory : m_directories){
+        std::size_t depth = std::distance(directory.begin(), directory.end());
+        depths[depth].push_back(directory);
+    }
+    std::vector<std::vector<std::filesystem::path>> ret;
+    for(auto& [depth, directories] : depths){
+        ret.push_back(std::move(directories));
+    }
+    return ret;
+}
+
+bool RebuildPlanner::isBelow(const std::filesystem::path& directory, const std::filesystem::path& ancestor)
+{
+    if(directory == ancestor){
+        return false;
+    }
+    auto itr = directory.begin();
+    for(const auto& component : ancestor){
+        if(itr == directory.end() || *itr != component){
+            return false;
+        }
+        ++itr;
+    }
+    return true;
+}
+
+bool RebuildPlanner::hasMakefile(const std::filesystem::path& directory)
+{
+    auto itr = m_makefiles.find(directory);
+    if(itr != m_makefiles.end()){
+        return itr->second;
+    }
+    bool found = false;
+    std::error_code error;
+    for(const auto& name : {"Makefile", "makefile", "GNUmakefile"}){
+        if(std::filesystem::is_regular_file(m_root / directory / name, error)){
+            found = true;
+            break;
+        }
+    }
+    m_makefiles[directory] = found;
+    return found;
+}
@@ -0,0 +1,211 @@
+#include "RemoteFileCache.hpp"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+RemoteFileCache::RemoteFileCache(const std::filesystem::path& directory, const uint64_t& budget) :
+    m_directory(directory), m_budget(budget), m_size(0), m_clock(0)
+{
+    readIndex();
+}
+
+bool RemoteFileCache::copyTo(const std::string& alias, const std::filesystem::path& remote, const RemoteStat& stat, const std::filesystem::path& destination)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto itr = m_entries.find(std::make_pair(alias, remote.generic_string()));
+    if(itr == m_entries.end() || !(itr->second.m_stat == stat)){
+        return false;
+    }
+    std::error_code error;
+    std::filesystem::copy_file(objectPath(itr->second.m_hash), destination, std::filesystem::copy_options::overwrite_existing, error);
+    if(error){
+        // object removed behind our back, forget about it
+        const auto hash = itr->second.m_hash;
+        m_entries.erase(itr);
+        removeUnreferenced(hash);
+        saveIndexLocked();
+        return false;
+    }
+    itr->second.m_lastUsed = ++m_clock;
+    saveIndexLocked();
+    return true;
+}
+
+bool RemoteFileCache::put(const std::string& alias, const std::filesystem::path& remote, const RemoteStat& stat, const std::filesystem::path& file)
+{
+    // hashing reads the whole file, don't block other threads meanwhile
+    const auto& hash = hashFile(file);
+    std::error_code error;
+    const auto& size = std::filesystem::file_size(file, error);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // size alone doesn't tell that the remote file is still the same
+    if(stat.m_modified.empty() || hash.empty() || error || m_budget == 0 || size > m_budget){
+        return false;
+    }
+    if(!m_objects.count(hash)){
+        std::filesystem::create_directories(m_directory / "objects", error);
+        std::filesystem::copy_file(file, objectPath(hash), std::filesystem::copy_options::overwrite_existing, error);
+        if(error){
+            return false;
+        }
+        m_objects[hash] = size;
+        m_size += size;
+    }
+    const Key key = std::make_pair(alias, remote.generic_string());
+    auto itr = m_entries.find(key);
+    const std::string previous = itr == m_entries.end() ? "" : itr->second.m_hash;
+    auto& entry = m_entries[key];
+    entry.m_stat = stat;
+    entry.m_hash = hash;
+    entry.m_lastUsed = ++m_clock;
+    if(!previous.empty() && previous != hash){
+        removeUnreferenced(previous);
+    }
+    evict();
+    return saveIndexLocked();
+}
+
+void RemoteFileCache::setBudget(const uint64_t& budget)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budget = budget;
+    evict();
+    saveIndexLocked();
+}
+
+bool RemoteFileCache::enabled() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_budget > 0;
+}
+
+uint64_t RemoteFileCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_size;
+}
+
+std::size_t RemoteFileCache::objects() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_objects.size();
+}
+
+void RemoteFileCache::evict()
+{
+    while(m_size > m_budget && !m_entries.empty()){
+        auto oldest = m_entries.begin();
+        for(auto itr = m_entries.begin(); itr != m_entries.end(); ++itr){
+            if(itr->second.m_lastUsed < oldest->second.m_lastUsed){
+                oldest = itr;
+            }
+        }
+        const auto hash = oldest->second.m_hash;
+        m_entries.erase(oldest);
+        removeUnreferenced(hash);
+    }
+}
+
+void RemoteFileCache::removeUnreferenced(const std::string& hash)
+{
+    for(const auto& entry : m_entries){
+        if(entry.second.m_hash == hash){
+            return;
+        }
+    }
+    auto itr = m_objects.find(hash);
+    if(itr == m_objects.end()){
+        return;
+    }
+    m_size -= itr->second;
+    m_objects.erase(itr);
+    std::error_code error;
+    std::filesystem::remove(objectPath(hash), error);
+}
+
+std::filesystem::path RemoteFileCache::objectPath(const std::string& hash) const
+{
+    return m_directory / "objects" / hash;
+}
+
+std::string RemoteFileCache::hashFile(const std::filesystem::path& file)
+{
+    std::ifstream stream(file, std::ios::binary);
+    if(!stream){
+        return "";
+    }
+    uint64_t hash = 14695981039346656037ull;
+    uint64_t size = 0;
+    std::vector<char> buffer(64 * 1024);
+    while(stream){
+        stream.read(buffer.data(), buffer.size());
+        const auto& read = static_cast<std::size_t>(stream.gcount());
+        for(std::size_t i = 0; i < read; ++i){
+            hash = (hash ^ static_cast<unsigned char>(buffer[i])) * 1099511628211ull;
+        }
+        size += read;
+    }
+    if(stream.bad()){
+        return "";
+    }
+    // size is part of the name, so different contents with colliding hash are still told apart by length
+    std::ostringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << hash << '-' << std::dec << size;
+    return ss.str();
+}
+
+bool RemoteFileCache::readIndex()
+{
+    std::ifstream file(m_directory / "index.txt");
+    if(!file) return false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_objects.clear();
+    m_size = 0;
+    std::string line;
+    while(std::getline(file, line)){
+        if(line.empty()) continue;
+        // alias size modified last_used hash remote_path
+        std::istringstream ss(line);
+        std::string alias;
+        Entry entry;
+        std::string remote;
+        if(!(ss >> alias >> entry.m_stat.m_size >> entry.m_stat.m_modified >> entry.m_lastUsed >> entry.m_hash) || !std::getline(ss, remote)){
+            std::cerr << "Malformed line in cache index: " << line << std::endl;
+            continue;
+        }
+        remote.erase(0, remote.find_first_not_of(' '));
+        std::error_code error;
+        const auto& size = std::filesystem::file_size(objectPath(entry.m_hash), error);
+        if(error){
+            continue;
+        }
+        if(!m_objects.count(entry.m_hash)){
+            m_objects[entry.m_hash] = size;
+            m_size += size;
+        }
+        m_clock = std::max(m_clock, entry.m_lastUsed);
+        m_entries[std::make_pair(alias, remote)] = entry;
+    }
+    return true;
+}
+
+bool RemoteFileCache::saveIndex()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return saveIndexLocked();
+}
+
+bool RemoteFileCache::saveIndexLocked()
+{
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    std::ofstream file(m_directory / "index.txt");
+    if(!file) return false;
+    for(const auto& [key, entry] : m_entries){
+        file << key.first << ' ' << entry.m_stat.m_size << ' ' << entry.m_stat.m_modified << ' ' << entry.m_lastUsed << ' ' << entry.m_hash << ' ' << key.second << '\n';
+    }
+    return true;
+}
@@ -0,0 +1,133 @@
+#include "RemotePrefetcher.hpp"
+#include <algorithm>
+
+RemotePrefetcher::RemotePrefetcher(const std::filesystem::path& directory, const std::size_t& maxConcurrency) :
+    m_directory(directory), m_maxConcurrency(std::max<std::size_t>(maxConcurrency, 1)), m_counter(0), m_executor(m_maxConcurrency)
+{
+
+}
+
+RemotePrefetcher::~RemotePrefetcher()
+{
+    // workers use this object, they must not outlive it
+    cancel();
+}
+
+void RemotePrefetcher::start(const FetchFactory& factory, const std::vector<std::filesystem::path>& remoteFiles)
+{
+    cancel();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    for(const auto& remote : remoteFiles){
+        if(m_entries.count(remote)){
+            continue;
+        }
+        m_entries[remote];
+        m_queue.push_back(remote);
+    }
+    const std::size_t workers = std::min(m_maxConcurrency, m_queue.size());
+    for(std::size_t i = 0; i < workers; ++i){
+        m_workers.push_back(m_executor.submit([this, factory](){
+            work(factory);
+        }));
+    }
+}
+
+std::optional<std::filesystem::path> RemotePrefetcher::take(const std::filesystem::path& remote)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto itr = m_entries.find(remote);
+    if(itr == m_entries.end()){
+        return std::nullopt;
+    }
+    if(itr->second.m_state == State::Queued){
+        // needed now, so it goes before the files which are needed later
+        m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), remote), m_queue.end());
+        m_queue.push_front(remote);
+    }
+    m_changed.wait(lock, [&itr](){
+        return itr->second.m_state != State::Queued && itr->second.m_state != State::Downloading;
+    });
+    if(itr->second.m_state != State::Done){
+        return std::nullopt;
+    }
+    itr->second.m_state = State::Taken;
+    return itr->second.m_local;
+}
+
+void RemotePrefetcher::cancel()
+{
+    std::vector<std::future<void>> workers;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for(const auto& remote : m_queue){
+            m_entries[remote].m_state = State::Failed;
+        }
+        m_queue.clear();
+        workers.swap(m_workers);
+    }
+    m_changed.notify_all();
+    for(auto& worker : workers){
+        worker.wait();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::error_code error;
+    for(auto& [remote, entry] : m_entries){
+        if(entry.m_state == State::Done || entry.m_state == State::Taken){
+            std::filesystem::remove_all(entry.m_local.parent_path(), error);
+            entry.m_state = State::Failed;
+        }
+    }
+}
+
+std::size_t RemotePrefetcher::downloaded() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::count_if(m_entries.begin(), m_entries.end(), [](const auto& entry){
+        return entry.second.m_state == State::Done || entry.second.m_state == State::Taken;
+    });
+}
+
+void RemotePrefetcher::work(const FetchFactory& factory)
+{
+    // without a fetch function every file fails, take() must never wait for a file nobody fetches
+    Fetch fetch;
+    try{
+        fetch = factory();
+    } catch(const std::exception&){
+    }
+    while(true){
+        std::filesystem::path remote;
+        std::filesystem::path directory;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(m_queue.empty()){
+                return;
+            }
+            remote = m_queue.front();
+            m_queue.pop_front();
+            m_entries[remote].m_state = State::Downloading;
+            // own directory for every file, files of the same name come from different remote directories
+            directory = m_directory / std::to_string(m_counter++);
+        }
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        bool fetched = false;
+        try{
+            fetched = fetch && fetch(remote, directory);
+        } catch(const std::exception&){
+            fetched = false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto& entry = m_entries[remote];
+            entry.m_state = fetched ? State::Done : State::Failed;
+            entry.m_local = directory / remote.filename();
+        }
+        if(!fetched){
+            std::filesystem::remove_all(directory, error);
+        }
+        m_changed.notify_all();
+    }
+}
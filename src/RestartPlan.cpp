@@ -0,0 +1,120 @@
+#include "RestartPlan.hpp"
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <algorithm>
+#include <cctype>
+
+std::pair<bool, std::string> RestartPlan::parse(const std::string& arg)
+{
+    m_targets.clear();
+    m_dependencies.clear();
+    m_started.clear();
+    m_finished.clear();
+    m_succeeded.clear();
+
+    std::vector<std::string> entries;
+    boost::split(entries, arg, boost::is_any_of(","), boost::token_compress_on);
+    for(const auto& entry : entries){
+        std::vector<std::string> names;
+        boost::split(names, entry, boost::is_any_of(":"), boost::token_compress_on);
+        names.erase(std::remove(names.begin(), names.end(), ""), names.end());
+        if(names.empty()){
+            continue;
+        }
+        const auto& target = normalize(names.front());
+        if(m_dependencies.count(target)){
+            return std::make_pair(false, "target listed twice: " + target);
+        }
+        m_targets.push_back(target);
+        auto& dependencies = m_dependencies[target];
+        for(auto itr = names.begin() + 1; itr != names.end(); ++itr){
+            dependencies.push_back(normalize(*itr));
+        }
+    }
+    if(m_targets.empty()){
+        return std::make_pair(false, "no target");
+    }
+    for(const auto& [target, dependencies] : m_dependencies){
+        for(const auto& dependency : dependencies){
+            if(!m_dependencies.count(dependency)){
+                return std::make_pair(false, target + " depends on " + dependency + " which is not restarted");
+            }
+        }
+    }
+
+    // dry run of the scheduling, whatever can't be started is part of a cycle
+    std::set<std::string> ordered;
+    bool progress = true;
+    while(progress){
+        progress = false;
+        for(const auto& target : m_targets){
+            const auto& dependencies = m_dependencies[target];
+            if(!ordered.count(target) && std::all_of(dependencies.begin(), dependencies.end(),
+                                                      [&ordered](const std::string& name){return ordered.count(name) > 0;})){
+                ordered.insert(target);
+                progress = true;
+            }
+        }
+    }
+    for(const auto& target : m_targets){
+        if(!ordered.count(target)){
+            return std::make_pair(false, "circular dependency of " + target);
+        }
+    }
+    return std::make_pair(true, "");
+}
+
+std::vector<std::string> RestartPlan::dependencies(const std::string& target) const
+{
+    auto itr = m_dependencies.find(target);
+    return itr == m_dependencies.end() ? std::vector<std::string>() : itr->second;
+}
+
+std::vector<std::string> RestartPlan::next()
+{
+    std::vector<std::string> ret;
+    for(const auto& target : m_targets){
+        const auto& dependencies = m_dependencies[target];
+        if(!m_started.count(target) && std::all_of(dependencies.begin(), dependencies.end(),
+                                                    [this](const std::string& name){return m_succeeded.count(name) > 0;})){
+            m_started.insert(target);
+            ret.push_back(target);
+        }
+    }
+    return ret;
+}
+
+std::vector<std::string> RestartPlan::finished(const std::string& target, const bool& ok)
+{
+    m_finished.insert(target);
+    if(ok){
+        m_succeeded.insert(target);
+        return {};
+    }
+    std::vector<std::string> skipped;
+    std::vector<std::string> failed = {target};
+    while(!failed.empty()){
+        const auto name = failed.back();
+        failed.pop_back();
+        for(const auto& dependent : m_targets){
+            const auto& dependencies = m_dependencies[dependent];
+            if(!m_started.count(dependent) && std::find(dependencies.begin(), dependencies.end(), name) != dependencies.end()){
+                m_started.insert(dependent);
+                m_finished.insert(dependent);
+                skipped.push_back(dependent);
+                failed.push_back(dependent);
+            }
+        }
+    }
+    return skipped;
+}
+
+std::string RestartPlan::normalize(const std::string& target)
+{
+    // s-name and S-name are the same server
+    std::string ret = target;
+    if(ret.size() > 2 && ret[1] == '-'){
+        ret.front() = toupper(ret.front());
+    }
+    return ret;
+}
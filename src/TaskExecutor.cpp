@@ -0,0 +1,56 @@
+#include "TaskExecutor.hpp"
+#include <algorithm>
+
+// executor whose worker runs on the current thread, if any
+static thread_local const TaskExecutor* s_current = nullptr;
+
+TaskExecutor::TaskExecutor(const std::size_t& threads) : m_stopping(false)
+{
+    for(std::size_t i = 0; i < std::max<std::size_t>(threads, 1); ++i){
+        m_workers.emplace_back(&TaskExecutor::run, this);
+    }
+}
+
+TaskExecutor::~TaskExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_ready.notify_all();
+    for(auto& worker : m_workers){
+        worker.join();
+    }
+}
+
+TaskExecutor& TaskExecutor::shared()
+{
+    // workers mostly wait on the network, so a few more than cores is fine
+    static TaskExecutor executor(std::clamp<std::size_t>(std::thread::hardware_concurrency(), 4, 16));
+    return executor;
+}
+
+bool TaskExecutor::isWorkerThread() const
+{
+    return s_current == this;
+}
+
+void TaskExecutor::run()
+{
+    s_current = this;
+    while(true){
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_ready.wait(lock, [this](){
+                return m_stopping || !m_tasks.empty();
+            });
+            if(m_tasks.empty()){
+                return; // stopping and nothing left
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+        task();
+    }
+}
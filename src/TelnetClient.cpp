@@ -1,17 +1,22 @@
 #include "TelnetClient.hpp"
-#include <sstream>
 #include <iostream>
+#include "EventLoop.hpp"
 #include "Utils.hpp"
 
-class BlockReadingGuard {
-public:
-    BlockReadingGuard(std::atomic<bool>& blockReadingFlag) : m_blockReadingFlag(blockReadingFlag) {m_blockReadingFlag = true;}
-    ~BlockReadingGuard() {m_blockReadingFlag = false;}
-private:
-    std::atomic<bool>& m_blockReadingFlag;
-};
+// amount of the latest output kept for prompt detection when the output goes to a capture
+static const std::size_t PROMPT_WINDOW = 4096;
+// accumulated data is trimmed to the prompt window once it gets bigger than that
+static const std::size_t MAX_ACCUMULATED = 64 * 1024;
+// silence after which command is considered finished, longer once it started to output (building)
+static const std::chrono::seconds SILENCE_TIMEOUT(20);
+static const std::chrono::seconds OUTPUT_SILENCE_TIMEOUT(60);
+// how long to wait for the prompt after interrupting streamed command
+static const std::chrono::seconds INTERRUPT_TIMEOUT(5);
+static const std::chrono::seconds KEEP_ALIVE_INTERVAL(300);
+static const std::chrono::seconds LOGIN_TIMEOUT(10);
+static const std::chrono::seconds INITIAL_SCRIPT_TIMEOUT(5);
 
-TelnetClient::TelnetClient() : m_showThreadOutput(false)
+TelnetClient::TelnetClient() : m_loopId(0), m_connected(false), m_showThreadOutput(false)
 {
 
 }
@@ -23,63 +28,151 @@ TelnetClient::~TelnetClient()
 
 bool TelnetClient::write(const uint8_t* data, const size_t& size)
 {
+    std::lock_guard<std::mutex> lock(m_sendMutex);
     return m_socket.send(data, size) == sf::Socket::Status::Done;
 }
 
 bool TelnetClient::write(const std::string& text)
 {
-    return m_socket.send(text.c_str(), text.size()) == sf::Socket::Status::Done;
+    return write(reinterpret_cast<const uint8_t*>(text.c_str()), text.size());
 }
 
 bool TelnetClient::isConnected() const
 {
-    return m_keepReading;
+    return m_connected;
 }
 
 void TelnetClient::close()
 {
-    m_pwd = m_home = "";
-    m_keepReading = false;
-    m_blockReading = false;
-    if (m_readThread.joinable()) {
-        m_readThread.join();
+    m_pwd = m_home = m_prompt = "";
+    m_connected = false;
+    if(m_loopId != 0){
+        EventLoop::instance().remove(m_loopId);
+        m_loopId = 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        abortLogin();
+        while(!m_commands.empty()){
+            finishCommand();
+        }
+        m_pipelinedScript.clear();
+        m_pipelinedResult = std::future<std::string>();
     }
     m_socket.disconnect();
 }
 
 bool TelnetClient::connect(const sf::IpAddress& ip, const uint16_t& port)
 {
-    if(m_keepReading){
+    if(m_connected){
         return false;
     }
+    if(m_loopId != 0){
+        // left registered by the previous, dropped connection
+        EventLoop::instance().remove(m_loopId);
+        m_loopId = 0;
+    }
     m_accumulatedData.clear();
     if(m_socket.connect(ip, port, sf::milliseconds(250)) != sf::Socket::Status::Done){
         return false;
     }
-    m_keepReading = true;
-    m_readThread = std::thread(&TelnetClient::handleReadThread, this);
+    m_decoder.reset();
+    const auto& requests = m_decoder.initialRequests();
+    write(requests.data(), requests.size());
+    m_lastSent = std::chrono::steady_clock::now();
+    m_connected = true;
+    m_loopId = EventLoop::instance().add(m_socket, [this](){
+        onReadable();
+    }, [this](){
+        onTick();
+    });
     return true;
 }
 
-bool TelnetClient::login(const std::string& username, const std::string& password)
+bool TelnetClient::login(const std::string& username, const std::string& password, const std::string& initialScript)
 {
-    std::promise<bool> authPromise;
-    std::future<bool> authFuture = authPromise.get_future();
-    registerCallback("login:", [this, &username](){
-        write(username);
-    });
-    registerCallback("Password:", [this, &password](){
-        write(password);
-    });
-    registerCallback(">", [&authPromise](){
-        authPromise.set_value(true);
-    });
+    auto login = std::make_shared<Login>();
+    login->m_username = username;
+    login->m_password = password;
+    login->m_script = initialScript;
+    auto authFuture = login->m_promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(!m_connected){
+            return false;
+        }
+        m_login = login;
+        // the login prompt may have arrived already, between connect and now
+        advanceLogin();
+    }
 
-    if(authFuture.wait_for(std::chrono::seconds(10)) == std::future_status::ready) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
-        return authFuture.get();
+    if(authFuture.wait_for(LOGIN_TIMEOUT) != std::future_status::ready){
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_login == login){
+            m_login.reset();
+        }
+        return false;
     }
-    return false;
+    return authFuture.get();
+}
+
+void TelnetClient::advanceLogin()
+{
+    while(m_login){
+        switch(m_login->m_stage){
+        case LoginStage::Username:
+            if(m_accumulatedData.find("login:") == std::string::npos){
+                return;
+            }
+            write(m_login->m_username + "\n");
+            m_login->m_stage = LoginStage::Password;
+            break;
+        case LoginStage::Password:
+            if(m_accumulatedData.find("Password:") == std::string::npos){
+                return;
+            }
+            write(m_login->m_password + "\n");
+            m_login->m_stage = LoginStage::Prompt;
+            break;
+        case LoginStage::Prompt:
+            if(m_accumulatedData.find('>') == std::string::npos){
+                const auto& asked = m_accumulatedData.rfind("login:");
+                if(asked != std::string::npos && m_accumulatedData.find_first_not_of(" \r\n", asked + 6) == std::string::npos){
+                    abortLogin(); // asked again, credentials were rejected
+                }
+                return;
+            }
+            if(!m_login->m_script.empty()){
+                // pipelined right away, without waiting for the caller to wake up
+                auto script = std::make_shared<Command>();
+                script->m_command = ". " + m_login->m_script;
+                m_pipelinedScript = m_login->m_script;
+                m_pipelinedResult = script->m_promise.get_future();
+                m_commands.push_back(script);
+                if(m_commands.size() == 1){
+                    sendNext();
+                }
+            }
+            m_login->m_promise.set_value(true);
+            m_login.reset();
+            break;
+        }
+        m_accumulatedData.clear();
+    }
+}
+
+void TelnetClient::abortLogin()
+{
+    if(m_login){
+        m_login->m_promise.set_value(false);
+        m_login.reset();
+    }
+}
+
+void TelnetClient::registerCallback(const std::string& trigger, const std::function<void()>& func)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_callbacks[trigger] = func;
 }
 
 void TelnetClient::showThreadOutput(const bool& val)
@@ -87,156 +180,296 @@ void TelnetClient::showThreadOutput(const bool& val)
     m_showThreadOutput = val;
 }
 
+void TelnetClient::setOutputFilter(const std::shared_ptr<OutputFilter>& filter)
+{
+    if(filter){
+        filter->setSink([](const char* data, const std::size_t& size){
+            std::cout.write(data, size);
+        });
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_outputFilter = filter;
+}
+
+void TelnetClient::print(const std::string& text)
+{
+    if(m_outputFilter){
+        m_outputFilter->feed(text);
+    } else{
+        std::cout << text;
+    }
+}
+
 bool TelnetClient::send(const std::string& str)
 {
-    return m_socket.send(str.c_str(), str.length()) == sf::Socket::Status::Done;
+    return write(str);
 }
 
 std::future<std::string> TelnetClient::executeCommand(const std::string& command, const bool& showResult, const bool& exitImmediately, const bool& showNewLine)
 {
-    keepAliveClock.restart();
-    return std::async(std::launch::async, [this, command, showResult, exitImmediately, showNewLine]() {
-        BlockReadingGuard guard(m_blockReading);
-        std::string fullCommand = command + "\n";;
-        std::string data;
+    auto queued = std::make_shared<Command>();
+    queued->m_command = command;
+    queued->m_showResult = showResult;
+    queued->m_exitImmediately = exitImmediately;
+    queued->m_showNewLine = showNewLine;
+    return enqueue(queued);
+}
 
-        if(!isConnected()){
-            return data;
-        }
-        
-        if (m_socket.send(fullCommand.c_str(), fullCommand.size()) != sf::Socket::Status::Done) {
-            throw std::runtime_error("Send failed");
+std::future<std::string> TelnetClient::executeCommand(const std::string& command, const std::shared_ptr<OutputCapture>& capture, const bool& showResult)
+{
+    auto queued = std::make_shared<Command>();
+    queued->m_command = command;
+    queued->m_showResult = showResult;
+    queued->m_capture = capture;
+    return enqueue(queued);
+}
+
+bool TelnetClient::stream(const std::string& command, const DataCallback& onData, const std::function<bool()>& stop)
+{
+    auto queued = std::make_shared<Command>();
+    queued->m_command = command;
+    queued->m_onData = onData;
+    queued->m_stop = stop;
+    try{
+        enqueue(queued).get();
+    } catch(const std::exception&){
+        return false;
+    }
+    return isConnected();
+}
+
+std::future<std::string> TelnetClient::enqueue(const std::shared_ptr<Command>& command)
+{
+    auto future = command->m_promise.get_future();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(!m_connected){
+        command->m_promise.set_value("");
+        return future;
+    }
+    m_commands.push_back(command);
+    if(m_commands.size() == 1){
+        sendNext();
+    }
+    return future;
+}
+
+void TelnetClient::sendNext()
+{
+    while(!m_commands.empty()){
+        auto& command = *m_commands.front();
+        if(!m_connected){
+            command.m_promise.set_value("");
+        } else if(!write(command.m_command + "\n")){
+            command.m_promise.set_exception(std::make_exception_ptr(std::runtime_error("Send failed")));
+        } else if(command.m_exitImmediately){
+            command.m_promise.set_value("");
+        } else{
+            m_lastSent = command.m_lastActivity = std::chrono::steady_clock::now();
+            return; // in flight until its prompt comes back
         }
+        m_commands.pop_front();
+    }
+}
 
-        if(exitImmediately){
-            return data;
+void TelnetClient::finishCommand()
+{
+    auto command = m_commands.front();
+    m_commands.pop_front();
+    std::string result;
+    if(!command->m_onData){
+        if(command->m_showResult && m_outputFilter){
+            m_outputFilter->finish();
         }
+        if(command->m_showResult && command->m_showNewLine){
+            std::cout << std::endl;
+        }
+        if(command->m_capture){
+            command->m_capture->finish();
+            result = command->m_capture->tail();
+        } else{
+            result = std::move(command->m_data);
+        }
+    }
+    command->m_promise.set_value(std::move(result));
+    sendNext();
+}
 
-        m_socket.setBlocking(false);
-        auto startTime = std::chrono::steady_clock::now();
-        bool building = false;
-        while (true) {
-            std::size_t received;
-            auto status = m_socket.receive(m_buffer, sizeof(m_buffer), received);
-            if (status == sf::Socket::Status::Done) {
-                std::string chunk(reinterpret_cast<char*>(m_buffer), received);
-                data += chunk;
+void TelnetClient::onReadable()
+{
+    if(!m_connected){
+        return;
+    }
+    std::size_t received;
+    auto status = m_socket.receive(m_buffer, sizeof(m_buffer), received);
+    if(status == sf::Socket::Status::Disconnected || status == sf::Socket::Status::Error){
+        disconnected();
+        return;
+    }
+    if(status != sf::Socket::Status::Done || received == 0){
+        return;
+    }
+    received = decodeReceived(received);
+    if(received == 0){
+        return; // chunk held only telnet commands
+    }
+    std::string chunk(reinterpret_cast<char*>(m_buffer), received);
 
-                if (showResult) {
-                    std::cout << chunk;
-                }
+    std::vector<std::function<void()>> triggered;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(!m_commands.empty()){
+            handleCommandOutput(*m_commands.front(), chunk);
+        } else{
+            handleIdleOutput(chunk, triggered);
+        }
+    }
+    // callbacks may write to the socket or wake up waiting threads, so they run unlocked
+    for(const auto& callback : triggered){
+        callback();
+        write(reinterpret_cast<const uint8_t*>("\n"), 1);
+    }
+}
 
-                // sometimes after some script executing we get results with current path enclosed in < path >,
-                // idk why is that, but the latter condition prevents early leaving
-                if (chunk.find('>') != std::string::npos && chunk.find('<') == std::string::npos) {
-                    m_pwd = Utils::getPwd(data);
-                    if(m_source.empty()){
-                        m_source = Utils::getSource(data);
-                    }
-                    break;
-                } // if we find string making target then we are building, increase exit time to 1 minute (set building to true)
-                else if(chunk.find("making target")){
-                    building = true;
-                }
+void TelnetClient::handleCommandOutput(Command& command, const std::string& chunk)
+{
+    command.m_lastActivity = std::chrono::steady_clock::now();
+    if(command.m_onData){
+        if(!command.m_interrupted){
+            command.m_onData(chunk.data(), chunk.size());
+            return;
+        }
+        // after Ctrl-C only wait for the prompt to come back
+        command.m_data += chunk;
+        if(command.m_data.find('>') != std::string::npos){
+            m_pwd = Utils::getPwd(command.m_data);
+            finishCommand();
+        }
+        return;
+    }
 
-                if (received == 0) {
-                    break;  // if no data is received, we can also exit
-                }
-                startTime = std::chrono::steady_clock::now();
-            } else if(status == sf::Socket::Status::NotReady){
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                if ((std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count() >= 20000 && !building) ||
-                    (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count() >= 60000 && building)) {
-                    break;
-                }   
-            } else {
-                m_socket.setBlocking(true);
-                throw std::runtime_error("Receive failed");
-            }
+    command.m_data += chunk;
+    if(command.m_capture){
+        command.m_capture->append(chunk);
+        if(command.m_data.size() > PROMPT_WINDOW){
+            command.m_data.erase(0, command.m_data.size() - PROMPT_WINDOW);
         }
-        if(showResult && showNewLine){
-            std::cout << std::endl;
+    }
+    if(command.m_showResult){
+        print(chunk);
+    }
+
+    // sometimes after some script executing we get results with current path enclosed in < path >,
+    // idk why is that, but the latter condition prevents early leaving
+    if(chunk.find('>') != std::string::npos && chunk.find('<') == std::string::npos){
+        m_pwd = Utils::getPwd(command.m_data);
+        if(m_source.empty()){
+            m_source = Utils::getSource(command.m_data);
         }
-        m_socket.setBlocking(true);
-        return data;
-    });
+        finishCommand();
+        return;
+    }
+    // command is running (e.g. building), allow longer silence from now on
+    command.m_outputStarted = true;
 }
 
-bool TelnetClient::executeInitialScript(const std::string& script)
+void TelnetClient::handleIdleOutput(const std::string& chunk, std::vector<std::function<void()>>& triggered)
 {
-    auto promise = executeCommand(". " + script);
-    if(promise.wait_for(std::chrono::seconds(5)) == std::future_status::ready){
-        m_home = m_pwd = Utils::getPwd(promise.get());
-        return true;
+    if(m_showThreadOutput){
+        print(chunk);
+    }
+    m_accumulatedData += chunk;
+    if(m_accumulatedData.size() > MAX_ACCUMULATED){
+        m_accumulatedData.erase(0, m_accumulatedData.size() - PROMPT_WINDOW);
     }
-    return false;
-}
 
-void TelnetClient::handleReadThread()
-{
-    sf::SocketSelector selector;
-    selector.add(m_socket);
-    
-    keepAliveClock.restart();
-    while (m_keepReading) {
-        if (selector.wait(sf::milliseconds(100))) {
-            if (!m_blockReading && selector.isReady(m_socket)) {
-                std::size_t received;
-                auto status = m_socket.receive(m_buffer, sizeof(m_buffer), received);
-                if (status == sf::Socket::Status::Done) {
-                    std::stringstream textStream;
-
-                    // handle commands
-                    for (std::size_t i = 0; i < received; ++i) {
-                        if (m_buffer[i] == 255 && m_home.empty()) {
-                            if (i + 1 < received && m_buffer[i + 1] == 255) {
-                                // This is an escaped 255 byte, so treat it as regular data.
-                                textStream << m_buffer[i];
-                                i += 1; // Skip the next 255.
-                            } else if (i + 2 < received) {
-                                handleOption(m_buffer[i + 1], m_buffer[i + 2]);
-                                i += 2; // Skip the two command bytes.
-                            }
-                        } else {
-                            textStream << m_buffer[i];
-                        }
-                    }
-
-
-                    std::string filteredStr = textStream.str();
-                    if (!filteredStr.empty() && m_showThreadOutput) {
-                        std::cout << filteredStr;
-                    }
-                    m_accumulatedData += filteredStr;
-
-                    if (m_accumulatedData.find('>') != std::string::npos && m_showThreadOutput) {
-                        m_pwd = Utils::getPwd(m_accumulatedData);
-                        m_accumulatedData.clear();
-                    }
-
-                    for(auto itr = m_callbacks.begin(); itr != m_callbacks.end(); ++itr){
-                        auto callback = *itr;
-                        if(m_accumulatedData.find(callback.first) != std::string::npos){
-                            callback.second();
-                            write(reinterpret_cast<const uint8_t*>("\n"), 1);
-                            m_callbacks.erase(itr);
-                            m_accumulatedData.clear();
-                            break;
-                        }
-                    }
-                } else if (status == sf::Socket::Status::Disconnected){
-                    close();
-                    return;
-                }
-            }
+    if(m_login){
+        advanceLogin();
+        return;
+    }
+
+    if(m_accumulatedData.find('>') != std::string::npos && m_showThreadOutput){
+        m_pwd = Utils::getPwd(m_accumulatedData);
+        m_accumulatedData.clear();
+    }
+
+    for(auto itr = m_callbacks.begin(); itr != m_callbacks.end(); ++itr){
+        if(m_accumulatedData.find(itr->first) != std::string::npos){
+            triggered.push_back(itr->second);
+            m_callbacks.erase(itr);
+            m_accumulatedData.clear();
+            break;
         }
+    }
+}
 
-        if(keepAliveClock.getElapsedTime().asSeconds() >= 300 && m_socket.isBlocking()){
-            void(m_socket.send(" ", 1));
+void TelnetClient::onTick()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(!m_connected){
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if(m_commands.empty()){
+        if(now - m_lastSent >= KEEP_ALIVE_INTERVAL){
+            write(" ");
             m_accumulatedData.clear();
-            keepAliveClock.restart();
+            m_lastSent = now;
+        }
+        return;
+    }
+
+    auto& command = *m_commands.front();
+    if(command.m_onData){
+        if(!command.m_interrupted && command.m_stop()){
+            write("\x03");
+            command.m_interrupted = true;
+            command.m_lastActivity = now;
+        } else if(command.m_interrupted && now - command.m_lastActivity >= INTERRUPT_TIMEOUT){
+            finishCommand();
+        }
+        return;
+    }
+    const auto& timeout = command.m_outputStarted ? OUTPUT_SILENCE_TIMEOUT : SILENCE_TIMEOUT;
+    if(now - command.m_lastActivity >= timeout){
+        finishCommand();
+    }
+}
+
+void TelnetClient::disconnected()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_connected = false;
+        abortLogin();
+        while(!m_commands.empty()){
+            finishCommand();
         }
     }
+    // on the loop thread removal is applied after the current iteration
+    EventLoop::instance().remove(m_loopId);
+}
+
+bool TelnetClient::executeInitialScript(const std::string& script)
+{
+    std::future<std::string> promise;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_pipelinedResult.valid() && m_pipelinedScript == script){
+            promise = std::move(m_pipelinedResult);
+        }
+        m_pipelinedScript.clear();
+    }
+    if(!promise.valid()){
+        promise = executeCommand(". " + script);
+    }
+    if(promise.wait_for(INITIAL_SCRIPT_TIMEOUT) == std::future_status::ready){
+        const auto& output = promise.get();
+        m_home = m_pwd = Utils::getPwd(output);
+        const auto& lastLine = output.find_last_of('\n');
+        m_prompt = output.substr(lastLine == std::string::npos ? 0 : lastLine + 1);
+        return true;
+    }
+    return false;
 }
 
 void TelnetClient::cdHome()
@@ -247,8 +480,12 @@ void TelnetClient::cdHome()
     }
 }
 
-void TelnetClient::handleOption(const uint8_t& command, const uint8_t& option)
+std::size_t TelnetClient::decodeReceived(const std::size_t& received)
 {
-    uint8_t response[] = {255, 252, option};
-    write(response, 3);
+    const auto& size = m_decoder.decode(m_buffer, received);
+    if(m_decoder.hasReplies()){
+        const auto& replies = m_decoder.takeReplies();
+        write(replies.data(), replies.size());
+    }
+    return size;
 }
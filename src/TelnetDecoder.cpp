@@ -0,0 +1,166 @@
+#include "TelnetDecoder.hpp"
+#include <cstring>
+
+using namespace Telnet;
+
+static bool acceptsRemote(const uint8_t& option)
+{
+    return option == OPT_SGA || option == OPT_ECHO;
+}
+
+static bool acceptsLocal(const uint8_t& option)
+{
+    return option == OPT_SGA || option == OPT_NAWS;
+}
+
+TelnetDecoder::TelnetDecoder(const uint16_t& width, const uint16_t& height) : m_width(width), m_height(height)
+{
+    reset();
+}
+
+void TelnetDecoder::reset()
+{
+    m_state = State::Data;
+    m_verb = 0;
+    m_local.fill(OptionState::No);
+    m_remote.fill(OptionState::No);
+    m_replies.clear();
+}
+
+std::size_t TelnetDecoder::decode(uint8_t* data, const std::size_t& size)
+{
+    std::size_t read = 0, written = 0;
+    while(read < size){
+        if(m_state == State::Data){
+            // copy whole runs of text at once, only IAC breaks them
+            const uint8_t* iac = static_cast<const uint8_t*>(std::memchr(data + read, IAC, size - read));
+            const std::size_t end = iac ? iac - data : size;
+            if(written != read){
+                std::memmove(data + written, data + read, end - read);
+            }
+            written += end - read;
+            read = end;
+            if(iac){
+                m_state = State::Iac;
+                ++read;
+            }
+            continue;
+        }
+
+        const uint8_t byte = data[read++];
+        switch(m_state){
+            case State::Iac:
+                if(byte == IAC){
+                    data[written++] = IAC; // escaped 255 data byte
+                    m_state = State::Data;
+                } else if(byte >= WILL){
+                    m_verb = byte;
+                    m_state = State::Negotiation;
+                } else if(byte == SB){
+                    m_state = State::Subnegotiation;
+                } else{
+                    m_state = State::Data; // NOP, GA and other single byte commands
+                }
+                break;
+            case State::Negotiation:
+                negotiate(m_verb, byte);
+                m_state = State::Data;
+                break;
+            case State::Subnegotiation:
+                // nothing we accept sends parameters, so the content is skipped
+                if(byte == IAC){
+                    m_state = State::SubnegotiationIac;
+                }
+                break;
+            case State::SubnegotiationIac:
+                m_state = byte == SE ? State::Data : State::Subnegotiation;
+                break;
+            default:
+                break;
+        }
+    }
+    return written;
+}
+
+std::vector<uint8_t> TelnetDecoder::initialRequests()
+{
+    m_remote[OPT_SGA] = OptionState::WantYes;
+    reply(DO, OPT_SGA);
+    m_local[OPT_NAWS] = OptionState::WantYes;
+    reply(WILL, OPT_NAWS);
+    return takeReplies();
+}
+
+std::vector<uint8_t> TelnetDecoder::takeReplies()
+{
+    std::vector<uint8_t> ret;
+    ret.swap(m_replies);
+    return ret;
+}
+
+void TelnetDecoder::negotiate(const uint8_t& verb, const uint8_t& option)
+{
+    switch(verb){
+        case WILL:
+            if(m_remote[option] == OptionState::No){
+                if(acceptsRemote(option)){
+                    m_remote[option] = OptionState::Yes;
+                    reply(DO, option);
+                } else{
+                    reply(DONT, option);
+                }
+            } else{
+                m_remote[option] = OptionState::Yes; // acknowledges our request or is already enabled
+            }
+            break;
+        case WONT:
+            if(m_remote[option] == OptionState::Yes){
+                reply(DONT, option);
+            }
+            m_remote[option] = OptionState::No;
+            break;
+        case DO:
+            if(m_local[option] == OptionState::No){
+                if(acceptsLocal(option)){
+                    m_local[option] = OptionState::Yes;
+                    reply(WILL, option);
+                    if(option == OPT_NAWS){
+                        sendWindowSize();
+                    }
+                } else{
+                    reply(WONT, option);
+                }
+            } else if(m_local[option] == OptionState::WantYes){
+                m_local[option] = OptionState::Yes;
+                if(option == OPT_NAWS){
+                    sendWindowSize();
+                }
+            }
+            break;
+        case DONT:
+            if(m_local[option] == OptionState::Yes){
+                reply(WONT, option);
+            }
+            m_local[option] = OptionState::No;
+            break;
+    }
+}
+
+void TelnetDecoder::reply(const uint8_t& verb, const uint8_t& option)
+{
+    m_replies.insert(m_replies.end(), {IAC, verb, option});
+}
+
+void TelnetDecoder::sendWindowSize()
+{
+    m_replies.insert(m_replies.end(), {IAC, SB, OPT_NAWS});
+    const uint8_t size[] = {static_cast<uint8_t>(m_width >> 8), static_cast<uint8_t>(m_width & 0xFF),
+                            static_cast<uint8_t>(m_height >> 8), static_cast<uint8_t>(m_height & 0xFF)};
+    for(const auto& byte : size){
+        m_replies.push_back(byte);
+        if(byte == IAC){
+            m_replies.push_back(IAC);
+        }
+    }
+    m_replies.insert(m_replies.end(), {IAC, SE});
+}
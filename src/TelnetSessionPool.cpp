@@ -0,0 +1,236 @@
+#include "TelnetSessionPool.hpp"
+#include "AddressCache.hpp"
+#include <vector>
+#include <algorithm>
+
+// sessions idle for shorter time than that are handed out without probing the shell
+static const auto HEALTH_CHECK_AFTER = std::chrono::seconds(30);
+
+TelnetSessionPool::Lease::Lease(Lease&& other) noexcept : m_pool(other.m_pool), m_alias(std::move(other.m_alias)), m_client(other.m_client)
+{
+    other.m_pool = nullptr;
+    other.m_client = nullptr;
+}
+
+TelnetSessionPool::Lease& TelnetSessionPool::Lease::operator=(Lease&& other) noexcept
+{
+    if(this != &other){
+        release();
+        m_pool = other.m_pool;
+        m_alias = std::move(other.m_alias);
+        m_client = other.m_client;
+        other.m_pool = nullptr;
+        other.m_client = nullptr;
+    }
+    return *this;
+}
+
+void TelnetSessionPool::Lease::release()
+{
+    if(m_pool && m_client){
+        m_pool->giveBack(m_alias, m_client);
+    }
+    m_pool = nullptr;
+    m_client = nullptr;
+}
+
+TelnetSessionPool::TelnetSessionPool(const std::size_t& maxSessionsPerHost, const std::chrono::seconds& idleTimeout) :
+m_maxSessionsPerHost(maxSessionsPerHost), m_idleTimeout(idleTimeout)
+{
+
+}
+
+TelnetSessionPool::~TelnetSessionPool()
+{
+    closeAll();
+}
+
+TelnetSessionPool::Lease TelnetSessionPool::acquire(const HostData& host, const std::chrono::milliseconds& timeout)
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto expired = takeExpiredLocked();
+    if(!expired.empty()){
+        // closing may block on the socket, nobody else has to wait for it
+        lock.unlock();
+        expired.clear();
+        lock.lock();
+    }
+    while(true){
+        auto& entry = m_hosts[host.m_alias];
+        auto idle = std::find_if(entry.m_sessions.begin(), entry.m_sessions.end(), [](const Session& session){
+            return !session.m_busy;
+        });
+        if(idle != entry.m_sessions.end()){
+            idle->m_busy = true;
+            TelnetClient* client = idle->m_client.get();
+            const auto lastUsed = idle->m_lastUsed;
+            lock.unlock();
+            if(isHealthy(*client, lastUsed)){
+                return Lease(this, host.m_alias, client);
+            }
+            // dead session, drop it and look again
+            std::unique_ptr<TelnetClient> dead;
+            lock.lock();
+            auto& sessions = m_hosts[host.m_alias].m_sessions;
+            auto itr = std::find_if(sessions.begin(), sessions.end(), [client](const Session& session){
+                return session.m_client.get() == client;
+            });
+            if(itr != sessions.end()){
+                dead = std::move(itr->m_client);
+                sessions.erase(itr);
+            }
+            lock.unlock();
+            dead.reset();
+            lock.lock();
+            continue;
+        }
+
+        if(entry.m_sessions.size() + entry.m_opening < m_maxSessionsPerHost){
+            ++entry.m_opening;
+            lock.unlock();
+            // opening takes seconds, other hosts and other openings must not wait for it
+            auto client = open(host);
+            lock.lock();
+            auto& opened = m_hosts[host.m_alias];
+            --opened.m_opening;
+            if(!client){
+                m_released.notify_all();
+                return Lease();
+            }
+            TelnetClient* raw = client.get();
+            opened.m_sessions.push_back({std::move(client), true, std::chrono::steady_clock::now()});
+            return Lease(this, host.m_alias, raw);
+        }
+
+        if(m_released.wait_until(lock, deadline) == std::cv_status::timeout){
+            return Lease();
+        }
+    }
+}
+
+void TelnetSessionPool::reapIdle()
+{
+    std::vector<std::unique_ptr<TelnetClient>> expired;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        expired = takeExpiredLocked();
+    }
+    expired.clear();
+}
+
+void TelnetSessionPool::closeAll()
+{
+    std::vector<std::unique_ptr<TelnetClient>> closing;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for(auto& pair : m_hosts){
+            auto& sessions = pair.second.m_sessions;
+            for(auto itr = sessions.begin(); itr != sessions.end();){
+                if(!itr->m_busy){
+                    closing.push_back(std::move(itr->m_client));
+                    itr = sessions.erase(itr);
+                } else{
+                    ++itr;
+                }
+            }
+        }
+    }
+    closing.clear();
+}
+
+void TelnetSessionPool::setMaxSessionsPerHost(const std::size_t& max)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_maxSessionsPerHost = std::max<std::size_t>(max, 1);
+    m_released.notify_all();
+}
+
+std::size_t TelnetSessionPool::sessions(const std::string& alias)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto itr = m_hosts.find(alias);
+    return itr == m_hosts.end() ? 0 : itr->second.m_sessions.size();
+}
+
+std::unique_ptr<TelnetClient> TelnetSessionPool::open(const HostData& host)
+{
+    auto ip = AddressCache::instance().resolve(host.m_hostname);
+    if(!ip.has_value()){
+        return nullptr;
+    }
+    uint16_t port = 23;
+    try{
+        if(!host.m_port.empty()){
+            port = static_cast<uint16_t>(std::stoi(host.m_port));
+        }
+    } catch(const std::exception&){
+        port = 23;
+    }
+    auto client = std::make_unique<TelnetClient>();
+    if(!client->connect(ip.value(), port) || !client->login(host.m_username, host.m_password, host.m_script) ||
+       !client->executeInitialScript(host.m_script)){
+        return nullptr;
+    }
+    return client;
+}
+
+bool TelnetSessionPool::isHealthy(TelnetClient& client, const std::chrono::steady_clock::time_point& lastUsed)
+{
+    if(!client.isConnected()){
+        return false;
+    }
+    if(std::chrono::steady_clock::now() - lastUsed < HEALTH_CHECK_AFTER){
+        return true;
+    }
+    // empty command only brings back the prompt
+    auto probe = client.executeCommand("");
+    if(probe.wait_for(std::chrono::seconds(5)) != std::future_status::ready){
+        return false;
+    }
+    try{
+        return probe.get().find('>') != std::string::npos;
+    } catch(const std::exception&){
+        return false;
+    }
+}
+
+void TelnetSessionPool::giveBack(const std::string& alias, TelnetClient* client)
+{
+    std::unique_ptr<TelnetClient> dead;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& sessions = m_hosts[alias].m_sessions;
+        auto itr = std::find_if(sessions.begin(), sessions.end(), [client](const Session& session){
+            return session.m_client.get() == client;
+        });
+        if(itr != sessions.end()){
+            if(itr->m_client->isConnected()){
+                itr->m_busy = false;
+                itr->m_lastUsed = std::chrono::steady_clock::now();
+            } else{
+                dead = std::move(itr->m_client);
+                sessions.erase(itr);
+            }
+        }
+        m_released.notify_all();
+    }
+}
+
+std::vector<std::unique_ptr<TelnetClient>> TelnetSessionPool::takeExpiredLocked()
+{
+    std::vector<std::unique_ptr<TelnetClient>> expired;
+    const auto now = std::chrono::steady_clock::now();
+    for(auto& pair : m_hosts){
+        auto& sessions = pair.second.m_sessions;
+        for(auto itr = sessions.begin(); itr != sessions.end();){
+            if(!itr->m_busy && (now - itr->m_lastUsed >= m_idleTimeout || !itr->m_client->isConnected())){
+                expired.push_back(std::move(itr->m_client));
+                itr = sessions.erase(itr);
+            } else{
+                ++itr;
+            }
+        }
+    }
+    return expired;
+}
@@ -0,0 +1,164 @@
+#include "ThreeWayMerge.hpp"
+#include <unordered_map>
+#include <algorithm>
+
+// line without its ending, CRLF and LF endings are the same line
+static std::string_view content(std::string_view line)
+{
+    while(!line.empty() && (line.back() == '\n' || line.back() == '\r')){
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+std::vector<std::string_view> ThreeWayMerge::splitLines(std::string_view text)
+{
+    std::vector<std::string_view> ret;
+    std::size_t begin = 0;
+    while(begin < text.size()){
+        auto end = text.find('\n', begin);
+        end = end == std::string_view::npos ? text.size() : end + 1;
+        ret.emplace_back(text.data() + begin, end - begin);
+        begin = end;
+    }
+    return ret;
+}
+
+std::vector<std::pair<std::size_t, std::size_t>> ThreeWayMerge::diff(const std::vector<int>& first, const std::vector<int>& second)
+{
+    std::vector<std::pair<std::size_t, std::size_t>> ret;
+    std::size_t prefix = 0;
+    while(prefix < first.size() && prefix < second.size() && first[prefix] == second[prefix]){
+        ret.emplace_back(prefix, prefix);
+        ++prefix;
+    }
+    std::size_t suffix = 0;
+    while(suffix < first.size() - prefix && suffix < second.size() - prefix &&
+          first[first.size() - 1 - suffix] == second[second.size() - 1 - suffix]){
+        ++suffix;
+    }
+
+    // Myers' greedy algorithm on what is left, trace of furthest reaching paths is kept for backtracking
+    const long n = static_cast<long>(first.size() - prefix - suffix);
+    const long m = static_cast<long>(second.size() - prefix - suffix);
+    const long offset = n + m + 1;
+    std::vector<long> v(2 * offset + 1, 0);
+    std::vector<std::vector<long>> trace;
+    auto a = [&](const long& i){return first[prefix + i];};
+    auto b = [&](const long& j){return second[prefix + j];};
+    long found = -1;
+    for(long d = 0; d <= n + m && found < 0; ++d){
+        for(long k = -d; k <= d; k += 2){
+            long x = (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1])) ? v[offset + k + 1] : v[offset + k - 1] + 1;
+            long y = x - k;
+            while(x < n && y < m && a(x) == b(y)){
+                ++x;
+                ++y;
+            }
+            v[offset + k] = x;
+            if(x >= n && y >= m){
+                found = d;
+                break;
+            }
+        }
+        trace.push_back(v);
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>> middle;
+    long x = n, y = m;
+    for(long d = found; d > 0; --d){
+        const auto& previous = trace[d - 1];
+        const long k = x - y;
+        const long previousK = (k == -d || (k != d && previous[offset + k - 1] < previous[offset + k + 1])) ? k + 1 : k - 1;
+        const long previousX = previous[offset + previousK];
+        const long previousY = previousX - previousK;
+        while(x > previousX && y > previousY){
+            middle.emplace_back(prefix + --x, prefix + --y);
+        }
+        x = previousX;
+        y = previousY;
+    }
+    while(x > 0 && y > 0){
+        middle.emplace_back(prefix + --x, prefix + --y);
+    }
+    ret.insert(ret.end(), middle.rbegin(), middle.rend());
+    for(std::size_t i = suffix; i > 0; --i){
+        ret.emplace_back(first.size() - i, second.size() - i);
+    }
+    return ret;
+}
+
+MergeResult ThreeWayMerge::merge(std::string_view base, std::string_view local, std::string_view remote)
+{
+    const auto& baseLines = splitLines(base);
+    const auto& localLines = splitLines(local);
+    const auto& remoteLines = splitLines(remote);
+
+    std::unordered_map<std::string_view, int> ids;
+    auto intern = [&ids](const std::vector<std::string_view>& lines){
+        std::vector<int> ret;
+        ret.reserve(lines.size());
+        for(const auto& line : lines){
+            ret.push_back(ids.emplace(content(line), static_cast<int>(ids.size())).first->second);
+        }
+        return ret;
+    };
+    const auto& baseIds = intern(baseLines);
+    const auto& localIds = intern(localLines);
+    const auto& remoteIds = intern(remoteLines);
+
+    // for every base line its matching line in local and remote, -1 if it was changed
+    std::vector<long> inLocal(baseIds.size(), -1), inRemote(baseIds.size(), -1);
+    for(const auto& [i, j] : diff(baseIds, localIds)){
+        inLocal[i] = static_cast<long>(j);
+    }
+    for(const auto& [i, j] : diff(baseIds, remoteIds)){
+        inRemote[i] = static_cast<long>(j);
+    }
+
+    MergeResult result;
+    auto same = [](const std::vector<int>& first, std::size_t firstBegin, std::size_t firstEnd,
+                   const std::vector<int>& second, std::size_t secondBegin, std::size_t secondEnd){
+        return firstEnd - firstBegin == secondEnd - secondBegin &&
+               std::equal(first.begin() + firstBegin, first.begin() + firstEnd, second.begin() + secondBegin);
+    };
+    auto append = [&result](const std::vector<std::string_view>& lines, std::size_t begin, const std::size_t& end){
+        for(; begin < end; ++begin){
+            // last line of one side may lack the newline, while the other side continues after it
+            if(!result.m_text.empty() && result.m_text.back() != '\n'){
+                result.m_text.push_back('\n');
+            }
+            result.m_text.append(lines[begin]);
+        }
+    };
+
+    std::size_t i = 0, l = 0, r = 0;
+    while(i < baseIds.size() || l < localIds.size() || r < remoteIds.size()){
+        if(i < baseIds.size() && inLocal[i] == static_cast<long>(l) && inRemote[i] == static_cast<long>(r)){
+            // unchanged on both sides
+            append(localLines, l, l + 1);
+            ++i, ++l, ++r;
+            continue;
+        }
+        // next base line kept by both sides ends the changed region
+        std::size_t nextI = i;
+        while(nextI < baseIds.size() && (inLocal[nextI] < 0 || inRemote[nextI] < 0)){
+            ++nextI;
+        }
+        const std::size_t nextL = nextI < baseIds.size() ? inLocal[nextI] : localIds.size();
+        const std::size_t nextR = nextI < baseIds.size() ? inRemote[nextI] : remoteIds.size();
+        if(same(baseIds, i, nextI, localIds, l, nextL)){
+            append(remoteLines, r, nextR);
+        } else if(same(baseIds, i, nextI, remoteIds, r, nextR) || same(localIds, l, nextL, remoteIds, r, nextR)){
+            append(localLines, l, nextL);
+        } else{
+            result.m_clean = false;
+            ++result.m_conflicts;
+        }
+        i = nextI, l = nextL, r = nextR;
+    }
+    if(!result.m_clean){
+        result.m_text.clear();
+    }
+    return result;
+}
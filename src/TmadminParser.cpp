@@ -0,0 +1,90 @@
+#include "TmadminParser.hpp"
+#include <sstream>
+#include <cctype>
+
+static bool isNumber(const std::string& str)
+{
+    if(str.empty()){
+        return false;
+    }
+    for(const auto& c : str){
+        if(!std::isdigit(static_cast<unsigned char>(c))){
+            return false;
+        }
+    }
+    return true;
+}
+
+void TmadminParser::parseLine(const std::string& line)
+{
+    auto begin = line.find_first_not_of(" \t\r>");
+    if(begin == std::string::npos){
+        m_inTable = false;
+        return;
+    }
+    if(line.compare(begin, 3, "---") == 0){
+        m_inTable = true;
+        return;
+    }
+    if(!m_inTable){
+        return;
+    }
+    // Prog Name, Queue Name, Grp Name, ID, RqDone, Load Done, Current Service
+    std::istringstream ss(line.substr(begin));
+    ServerState state;
+    std::string queue, id, requests, load;
+    if(!(ss >> state.m_program >> queue >> state.m_group >> id >> requests >> load) || !isNumber(id) || !isNumber(requests)){
+        m_inTable = false;
+        return;
+    }
+    state.m_id = std::stoi(id);
+    std::getline(ss, state.m_status);
+    auto first = state.m_status.find_first_not_of(" \t");
+    auto last = state.m_status.find_last_not_of(" \t\r");
+    state.m_status = first == std::string::npos ? "" : state.m_status.substr(first, last - first + 1);
+    m_servers.push_back(std::move(state));
+}
+
+void TmadminParser::reset()
+{
+    m_servers.clear();
+    m_inTable = false;
+}
+
+bool TmadminParser::isReady(const std::string& target) const
+{
+    const bool server = target.size() > 2 && toupper(target.front()) == 'S' && target[1] == '-';
+    const bool group = target.size() > 2 && toupper(target.front()) == 'G' && target[1] == '-';
+    const auto& name = target.substr(server || group ? 2 : 0);
+    std::size_t running = 0;
+    for(const auto& state : m_servers){
+        if((server && !matchesProgram(state.m_program, name)) || (group && state.m_group != name)){
+            continue;
+        }
+        for(const auto& word : {"DEAD", "Restarting", "RESTARTING", "Suspended", "SUSPENDED"}){
+            if(state.m_status.find(word) != std::string::npos){
+                return false;
+            }
+        }
+        ++running;
+    }
+    return running > 0;
+}
+
+std::string TmadminParser::pollCommand(const std::string& target)
+{
+    // telnet client takes '>' for the shell prompt, so neither the echoed command nor tmadmin prompts may contain it (076 is its octal code)
+    const std::string prompts = " | tmadmin -r | tr -d '\\076'";
+    if(target.size() > 2 && toupper(target.front()) == 'G' && target[1] == '-'){
+        return "echo 'psr -g " + target.substr(2) + "'" + prompts;
+    }
+    return "echo psr" + prompts;
+}
+
+bool TmadminParser::matchesProgram(const std::string& program, const std::string& name)
+{
+    if(!program.empty() && program.back() == '+'){
+        return name.compare(0, program.size() - 1, program, 0, program.size() - 1) == 0;
+    }
+    return program == name;
+}
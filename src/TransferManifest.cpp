@@ -0,0 +1,124 @@
+#include "TransferManifest.hpp"
+#include "RemoteFileCache.hpp"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+TransferManifest::TransferManifest(const std::filesystem::path& directory) : m_directory(directory)
+{
+    readIndex();
+}
+
+bool TransferManifest::record(const std::string& alias, const std::filesystem::path& remote, const std::filesystem::path& file)
+{
+    const auto& hash = RemoteFileCache::hashFile(file);
+    if(hash.empty()){
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::error_code error;
+    if(!std::filesystem::exists(objectPath(hash), error)){
+        std::filesystem::create_directories(m_directory / "objects", error);
+        std::filesystem::copy_file(file, objectPath(hash), std::filesystem::copy_options::overwrite_existing, error);
+        if(error){
+            return false;
+        }
+    }
+    auto& entry = m_entries[std::make_pair(alias, remote.generic_string())];
+    const auto previous = entry;
+    entry = hash;
+    if(!previous.empty() && previous != hash){
+        removeUnreferenced(previous);
+    }
+    return saveIndexLocked();
+}
+
+void TransferManifest::forget(const std::string& alias, const std::filesystem::path& remote)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto itr = m_entries.find(std::make_pair(alias, remote.generic_string()));
+    if(itr == m_entries.end()){
+        return;
+    }
+    const auto hash = itr->second;
+    m_entries.erase(itr);
+    removeUnreferenced(hash);
+    saveIndexLocked();
+}
+
+std::optional<std::string> TransferManifest::base(const std::string& alias, const std::filesystem::path& remote) const
+{
+    std::filesystem::path object;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto itr = m_entries.find(std::make_pair(alias, remote.generic_string()));
+        if(itr == m_entries.end()){
+            return std::nullopt;
+        }
+        object = objectPath(itr->second);
+    }
+    std::ifstream file(object, std::ios::binary);
+    if(!file.is_open()){
+        return std::nullopt;
+    }
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+std::size_t TransferManifest::entries() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+bool TransferManifest::readIndex()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    std::ifstream file(m_directory / "manifest.txt");
+    if(!file.is_open()){
+        return false;
+    }
+    std::string line;
+    while(std::getline(file, line)){
+        std::istringstream iss(line);
+        std::string alias, hash, remote;
+        if(!(iss >> alias >> hash) || !std::getline(iss >> std::ws, remote) || remote.empty()){
+            std::cerr << "Malformed transfer manifest line: " << line << std::endl;
+            continue;
+        }
+        m_entries[std::make_pair(alias, remote)] = hash;
+    }
+    return true;
+}
+
+void TransferManifest::removeUnreferenced(const std::string& hash)
+{
+    for(const auto& entry : m_entries){
+        if(entry.second == hash){
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::remove(objectPath(hash), error);
+}
+
+std::filesystem::path TransferManifest::objectPath(const std::string& hash) const
+{
+    return m_directory / "objects" / hash;
+}
+
+bool TransferManifest::saveIndexLocked()
+{
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    std::ofstream file(m_directory / "manifest.txt", std::ios::trunc);
+    if(!file.is_open()){
+        return false;
+    }
+    for(const auto& [key, hash] : m_entries){
+        file << key.first << ' ' << hash << ' ' << key.second << '\n';
+    }
+    return file.good();
+}
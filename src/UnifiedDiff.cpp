@@ -0,0 +1,89 @@
+#include "UnifiedDiff.hpp"
+#include "ThreeWayMerge.hpp"
+#include <unordered_map>
+#include <vector>
+
+static std::string_view content(std::string_view line)
+{
+    while(!line.empty() && (line.back() == '\n' || line.back() == '\r')){
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+std::string UnifiedDiff::render(std::string_view from, std::string_view to, const std::string& fromName,
+                                const std::string& toName, const std::size_t& context)
+{
+    const auto& fromLines = ThreeWayMerge::splitLines(from);
+    const auto& toLines = ThreeWayMerge::splitLines(to);
+    std::unordered_map<std::string_view, int> ids;
+    auto intern = [&ids](const std::vector<std::string_view>& lines){
+        std::vector<int> ret;
+        for(const auto& line : lines){
+            ret.push_back(ids.emplace(content(line), static_cast<int>(ids.size())).first->second);
+        }
+        return ret;
+    };
+    const auto& fromIds = intern(fromLines);
+    const auto& toIds = intern(toLines);
+
+    // edit script, every operation knows its position in both texts
+    struct Operation{
+        char m_type;
+        std::size_t m_from;
+        std::size_t m_to;
+    };
+    std::vector<Operation> operations;
+    std::size_t i = 0, j = 0;
+    auto matches = ThreeWayMerge::diff(fromIds, toIds);
+    matches.emplace_back(fromIds.size(), toIds.size());
+    for(const auto& [matchFrom, matchTo] : matches){
+        for(; i < matchFrom; ++i){
+            operations.push_back({'-', i, j});
+        }
+        for(; j < matchTo; ++j){
+            operations.push_back({'+', i, j});
+        }
+        if(i < fromIds.size() && j < toIds.size()){
+            operations.push_back({' ', i++, j++});
+        }
+    }
+
+    std::string ret;
+    std::size_t k = 0;
+    while(k < operations.size()){
+        if(operations[k].m_type == ' '){
+            ++k;
+            continue;
+        }
+        // hunk grows while the next change is close enough to share context
+        const std::size_t begin = k > context ? k - context : 0;
+        std::size_t last = k;
+        for(std::size_t next = k + 1; next < operations.size() && next <= last + 2 * context + 1; ++next){
+            if(operations[next].m_type != ' '){
+                last = next;
+            }
+        }
+        const std::size_t end = std::min(operations.size(), last + 1 + context);
+        std::size_t fromCount = 0, toCount = 0;
+        for(std::size_t l = begin; l < end; ++l){
+            fromCount += operations[l].m_type != '+';
+            toCount += operations[l].m_type != '-';
+        }
+        if(ret.empty()){
+            ret = "--- " + fromName + "\n+++ " + toName + "\n";
+        }
+        const auto& fromStart = operations[begin].m_from + (fromCount ? 1 : 0);
+        const auto& toStart = operations[begin].m_to + (toCount ? 1 : 0);
+        ret += "@@ -" + std::to_string(fromStart) + ',' + std::to_string(fromCount) +
+               " +" + std::to_string(toStart) + ',' + std::to_string(toCount) + " @@\n";
+        for(std::size_t l = begin; l < end; ++l){
+            const auto& line = operations[l].m_type == '+' ? toLines[operations[l].m_to] : fromLines[operations[l].m_from];
+            ret += operations[l].m_type;
+            ret += content(line);
+            ret += '\n';
+        }
+        k = end;
+    }
+    return ret;
+}
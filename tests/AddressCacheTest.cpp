@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "AddressCache.hpp"
+
+TEST(AddressCacheTest, SeededAddressIsUsedInsteadOfResolving)
+{
+    auto& cache = AddressCache::instance();
+    cache.seed("seeded.invalid", sf::IpAddress(10, 1, 2, 3));
+    const auto& address = cache.resolve("seeded.invalid");
+    ASSERT_TRUE(address.has_value());
+    EXPECT_EQ(address->toString(), "10.1.2.3");
+
+    cache.forget("seeded.invalid");
+    EXPECT_FALSE(cache.resolve("seeded.invalid").has_value());
+}
+
+TEST(AddressCacheTest, ExpiredAddressIsResolvedAgain)
+{
+    auto& cache = AddressCache::instance();
+    cache.setTtl(std::chrono::seconds(0));
+    cache.seed("127.0.0.1", sf::IpAddress(10, 1, 2, 3));
+    const auto& address = cache.resolve("127.0.0.1");
+    ASSERT_TRUE(address.has_value());
+    EXPECT_EQ(address->toString(), "127.0.0.1");
+    cache.setTtl(std::chrono::minutes(10));
+}
+
+TEST(AddressCacheTest, ConcurrentCallersGetSameAddress)
+{
+    auto& cache = AddressCache::instance();
+    cache.forget("127.0.0.1");
+    std::vector<std::optional<sf::IpAddress>> addresses(8);
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < addresses.size(); ++i){
+        threads.emplace_back([&cache, &addresses, i](){
+            addresses[i] = cache.resolve("127.0.0.1");
+        });
+    }
+    for(auto& thread : threads){
+        thread.join();
+    }
+    for(const auto& address : addresses){
+        ASSERT_TRUE(address.has_value());
+        EXPECT_EQ(address->toString(), "127.0.0.1");
+    }
+}
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include "FileTestHelper.hpp"
+#include "BuildHistory.hpp"
+
+using namespace std::chrono_literals;
+
+TEST(BuildHistoryTest, RecordedTimesAreReadByNewObject)
+{
+    const std::string file = "build_times.txt";
+    FileTestHelper helper;
+    {
+        BuildHistory history(file);
+        EXPECT_FALSE(history.estimate("host", "server").has_value());
+        history.record("host", "server", 4000ms);
+        history.record("host", "", 1000ms);
+        history.record("host", "server", 2000ms);
+    }
+    {
+        BuildHistory history(file);
+        EXPECT_EQ(history.estimate("host", "server"), std::optional<std::chrono::milliseconds>(3000ms));
+        EXPECT_EQ(history.estimate("host", ""), std::optional<std::chrono::milliseconds>(1000ms));
+        EXPECT_FALSE(history.estimate("other", "server").has_value());
+    }
+    helper.deleteFile(file);
+}
+
+TEST(BuildHistoryTest, LongestBuildsComeFirst)
+{
+    const std::string file = "build_times.txt";
+    FileTestHelper helper;
+    BuildHistory history(file);
+    history.record("host", "fast", 1000ms);
+    history.record("host", "slow", 9000ms);
+    history.record("other", "fast", 20000ms);
+
+    // unknown directory is expected to take the average of known ones
+    const auto& ordered = history.longestFirst("host", {"fast", "unknown", "slow"});
+    EXPECT_EQ(ordered, std::vector<std::filesystem::path>({"slow", "unknown", "fast"}));
+    helper.deleteFile(file);
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "BuildOutputParser.hpp"
+
+TEST(BuildOutputParserTest, CountsTargets)
+{
+    BuildOutputParser parser;
+    parser.parseLine("making target 'libcore.a'");
+    EXPECT_EQ(parser.currentTarget(), "libcore.a");
+    parser.parseLine("cc -c core.c");
+    parser.parseLine("making target server");
+    parser.finish();
+    ASSERT_EQ(parser.targets().size(), 2);
+    EXPECT_EQ(parser.targets()[0].m_name, "libcore.a");
+    EXPECT_EQ(parser.targets()[1].m_name, "server");
+    EXPECT_TRUE(parser.currentTarget().empty());
+}
+
+TEST(BuildOutputParserTest, ExtractsGccDiagnostics)
+{
+    BuildOutputParser parser;
+    parser.parseLine("making target server");
+    parser.parseLine("src/main.c:42:7: error: 'x' undeclared");
+    parser.parseLine("src/util.c:3: warning: unused variable 'y'\r");
+    parser.parseLine("In file included from a.h:1:");
+    ASSERT_EQ(parser.diagnostics().size(), 2);
+    EXPECT_EQ(parser.errors(), 1);
+    EXPECT_EQ(parser.warnings(), 1);
+    EXPECT_EQ(parser.diagnostics()[0].m_file, "src/main.c");
+    EXPECT_EQ(parser.diagnostics()[0].m_line, 42);
+    EXPECT_EQ(parser.diagnostics()[0].m_message, "'x' undeclared");
+    EXPECT_EQ(parser.diagnostics()[0].m_target, "server");
+    EXPECT_FALSE(parser.diagnostics()[1].m_error);
+}
+
+TEST(BuildOutputParserTest, ExtractsXlcDiagnostics)
+{
+    BuildOutputParser parser;
+    parser.parseLine("\"serv.c\", line 120.10: 1506-045 (S) Undeclared identifier a.");
+    parser.parseLine("\"serv.c\", line 7.1: 1506-166 (W) Definition of function f requires parentheses.");
+    parser.parseLine("\"serv.c\", line 8.1: 1506-000 (I) Just info.");
+    EXPECT_EQ(parser.errors(), 1);
+    EXPECT_EQ(parser.warnings(), 1);
+    EXPECT_EQ(parser.diagnostics()[0].m_line, 120);
+    EXPECT_EQ(parser.diagnostics()[0].m_message, "1506-045 (S) Undeclared identifier a.");
+}
+
+TEST(BuildOutputParserTest, ExtractsLinkerFailures)
+{
+    BuildOutputParser parser;
+    parser.parseLine("making target server");
+    parser.parseLine("main.c:(.text+0x1f): undefined reference to `foo'");
+    parser.parseLine("collect2: error: ld returned 1 exit status");
+    ASSERT_EQ(parser.errors(), 1);
+    EXPECT_TRUE(parser.diagnostics()[0].m_linker);
+    EXPECT_EQ(parser.diagnostics()[0].m_file, "main.c");
+
+    BuildOutputParser alone;
+    alone.parseLine("collect2: error: ld returned 1 exit status");
+    EXPECT_EQ(alone.errors(), 1);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include "Checksum.hpp"
+
+static FileChecksum checksum(const std::string& data, const bool& normalizeCrlf = false)
+{
+    return Checksum::ofData(data, normalizeCrlf);
+}
+
+TEST(ChecksumTest, MatchesPosixCksum)
+{
+    // values printed by `printf ... | cksum`
+    EXPECT_EQ(checksum("").m_crc, 4294967295u);
+    EXPECT_EQ(checksum("hello\n").m_crc, 3015617425u);
+    EXPECT_EQ(checksum("hello\n").m_size, 6);
+}
+
+TEST(ChecksumTest, ChunksGiveSameResult)
+{
+    const std::string data = "line one\r\nline two\r\nlast\r";
+    for(const bool& normalize : {false, true}){
+        Checksum chunked(normalize);
+        for(std::size_t i = 0; i < data.size(); i += 3){
+            chunked.update(data.data() + i, std::min<std::size_t>(3, data.size() - i));
+        }
+        EXPECT_EQ(chunked.finish(), checksum(data, normalize));
+    }
+}
+
+TEST(ChecksumTest, CrlfIsNormalized)
+{
+    EXPECT_EQ(checksum("a\r\nb\r\n", true), checksum("a\nb\n"));
+    EXPECT_EQ(checksum("a\rb\r", true), checksum("a\rb\r"));
+    EXPECT_NE(checksum("a\r\nb\r\n"), checksum("a\nb\n"));
+}
+
+TEST(ChecksumTest, ParsesCksumOutput)
+{
+    const auto& parsed = Checksum::parseOutput("cd /src/ && cat list | while IFS= read -r f; do cksum \"$f\"; done\r\n"
+                                               "3015617425 6 dir/hello.txt\r\n"
+                                               "cksum: dir/missing.c: No such file or directory\r\n"
+                                               "4294967295 0 empty\r\n"
+                                               "3015617425 6 dir/with  two spaces.txt\r\n"
+                                               "user@host:/src >");
+    ASSERT_EQ(parsed.size(), 3);
+    EXPECT_EQ(parsed.at("dir/hello.txt"), (FileChecksum{3015617425u, 6}));
+    EXPECT_EQ(parsed.at("empty").m_size, 0);
+    EXPECT_EQ(parsed.at("dir/with  two spaces.txt").m_size, 6);
+}
@@ -99,6 +99,32 @@ TEST(ConfigurationTest, RenamingHost)
     helper.deleteFile(file);
 }
 
+TEST(ConfigurationTest, HostGroups)
+{
+    const std::string file = "conf.txt";
+    FileTestHelper helper;
+    helper.createFile(file, "DEFAULT_HOST: dev\n\nGROUP: all dev,test\n\n"
+                            "ALIAS: dev\nHOST: devhost\n\nALIAS: test\nHOST: testhost\n\nALIAS: int\nHOST: inthost\n");
+    {
+        Configuration conf(file);
+        EXPECT_EQ(conf.getGroup("all"), std::vector<std::string>({"dev", "test"}));
+        EXPECT_EQ(conf.expandHosts("int,all,dev"), std::vector<std::string>({"int", "dev", "test"}));
+        EXPECT_TRUE(conf.expandHosts("dev,unknown").empty());
+        EXPECT_FALSE(conf.addGroup("dev", {"test"}));
+        EXPECT_FALSE(conf.addGroup("broken", {"unknown"}));
+        EXPECT_TRUE(conf.addGroup("pair", {"int", "test"}));
+        ASSERT_TRUE(conf.getHost("test").has_value());
+        EXPECT_EQ(conf.getHost("test")->m_hostname, "testhost");
+        EXPECT_FALSE(conf.getHost("unknown").has_value());
+    }
+    {
+        Configuration conf(file);
+        EXPECT_EQ(conf.getGroup("pair"), std::vector<std::string>({"int", "test"}));
+        EXPECT_EQ(conf.getGroup("all"), std::vector<std::string>({"dev", "test"}));
+    }
+    helper.deleteFile(file);
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "EventLoop.hpp"
+
+// connected pair of sockets over loopback
+struct SocketPair{
+    sf::TcpListener m_listener;
+    sf::TcpSocket m_client;
+    sf::TcpSocket m_server;
+
+    bool connect(){
+        if(m_listener.listen(sf::Socket::AnyPort) != sf::Socket::Status::Done){
+            return false;
+        }
+        std::thread accept([this](){
+            void(m_listener.accept(m_server));
+        });
+        const bool connected = m_client.connect(sf::IpAddress::LocalHost, m_listener.getLocalPort()) == sf::Socket::Status::Done;
+        accept.join();
+        return connected;
+    }
+};
+
+template<typename Predicate>
+static bool waitFor(const Predicate& predicate)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while(!predicate()){
+        if(std::chrono::steady_clock::now() > deadline){
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+TEST(EventLoopTest, TickRunsUntilSocketIsRemoved)
+{
+    SocketPair sockets;
+    ASSERT_TRUE(sockets.connect());
+    std::atomic<int> ticks(0);
+    std::atomic<bool> onLoopThread(true);
+    auto& loop = EventLoop::instance();
+    const auto& id = loop.add(sockets.m_server, [](){}, [&](){
+        onLoopThread = onLoopThread && loop.isLoopThread();
+        ++ticks;
+    });
+    // nothing to read, so ticks come from the 20 ms wait timing out
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_GE(ticks, 3);
+    EXPECT_FALSE(loop.isLoopThread());
+
+    loop.remove(id);
+    const int removed = ticks;
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_EQ(ticks, removed);
+    EXPECT_TRUE(onLoopThread);
+}
+
+TEST(EventLoopTest, ReadableHandlerGetsData)
+{
+    SocketPair sockets;
+    ASSERT_TRUE(sockets.connect());
+    std::mutex mutex;
+    std::string received;
+    auto& loop = EventLoop::instance();
+    const auto& id = loop.add(sockets.m_server, [&](){
+        char buffer[64];
+        std::size_t size = 0;
+        if(sockets.m_server.receive(buffer, sizeof(buffer), size) == sf::Socket::Status::Done){
+            std::lock_guard<std::mutex> lock(mutex);
+            received.append(buffer, size);
+        }
+    }, [](){});
+    const std::string message = "hello";
+    ASSERT_EQ(sockets.m_client.send(message.data(), message.size()), sf::Socket::Status::Done);
+    EXPECT_TRUE(waitFor([&](){
+        std::lock_guard<std::mutex> lock(mutex);
+        return received == message;
+    }));
+    loop.remove(id);
+}
+
+TEST(EventLoopTest, HandlerMayRemoveItsOwnSocket)
+{
+    SocketPair sockets;
+    ASSERT_TRUE(sockets.connect());
+    std::atomic<int> calls(0);
+    std::atomic<std::size_t> id(0);
+    auto& loop = EventLoop::instance();
+    // removing from the loop thread must not wait for the loop itself
+    id = loop.add(sockets.m_server, [](){}, [&](){
+        if(id == 0){
+            return; // loop was faster than the assignment
+        }
+        ++calls;
+        loop.remove(id);
+    });
+    EXPECT_TRUE(waitFor([&](){
+        return calls > 0;
+    }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_EQ(calls, 1);
+
+    // other sockets keep being served
+    std::atomic<int> ticks(0);
+    const auto& other = loop.add(sockets.m_client, [](){}, [&](){
+        ++ticks;
+    });
+    EXPECT_TRUE(waitFor([&](){
+        return ticks > 2;
+    }));
+    loop.remove(other);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "FileTestHelper.hpp"
+#include "FileChunker.hpp"
+
+static std::string read(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+TEST(FileChunkerTest, ChunksEndAfterNewline)
+{
+    FileTestHelper helper;
+    std::string content;
+    for(int i = 0; i < 100; ++i){
+        content += "line " + std::to_string(i) + "\r\n";
+    }
+    helper.createFile("big.txt", content);
+    const auto& chunks = FileChunker::split("big.txt", "chunks_test", 100);
+    ASSERT_GT(chunks.size(), 5);
+    EXPECT_EQ(chunks.front().filename(), "big.txt.part000");
+    std::string joined;
+    for(const auto& chunk : chunks){
+        const auto& part = read(chunk);
+        EXPECT_EQ(part.back(), '\n');
+        joined += part;
+    }
+    EXPECT_EQ(joined, content);
+    std::filesystem::remove_all("chunks_test");
+    helper.deleteFile("big.txt");
+}
+
+TEST(FileChunkerTest, DataWithoutNewlinesIsSplitBySize)
+{
+    FileTestHelper helper;
+    const std::string content(1000, 'x');
+    helper.createFile("blob.bin", content);
+    const auto& chunks = FileChunker::split("blob.bin", "chunks_test", 300);
+    ASSERT_EQ(chunks.size(), 4);
+    EXPECT_EQ(read(chunks[0]).size(), 300);
+    EXPECT_EQ(read(chunks[3]).size(), 100);
+    std::filesystem::remove_all("chunks_test");
+    helper.deleteFile("blob.bin");
+}
+
+TEST(FileChunkerTest, SmallFileIsOneChunk)
+{
+    FileTestHelper helper;
+    helper.createFile("small.txt", "abc\n");
+    const auto& chunks = FileChunker::split("small.txt", "chunks_test", 100);
+    ASSERT_EQ(chunks.size(), 1);
+    EXPECT_EQ(read(chunks[0]), "abc\n");
+    EXPECT_TRUE(FileChunker::split("missing.txt", "chunks_test", 100).empty());
+    std::filesystem::remove_all("chunks_test");
+    helper.deleteFile("small.txt");
+}
+
+TEST(FileChunkerTest, ContentInMemoryGivesSameChunks)
+{
+    FileTestHelper helper;
+    std::string content;
+    for(int i = 0; i < 100; ++i){
+        content += "line " + std::to_string(i) + (i % 7 ? "\n" : "");
+    }
+    helper.createFile("big.txt", content);
+    const auto& fromFile = FileChunker::split("big.txt", "chunks_test", 50);
+    std::vector<std::string> expected;
+    for(const auto& chunk : fromFile){
+        expected.push_back(read(chunk));
+    }
+    const auto& fromMemory = FileChunker::split(content, "big.txt", "chunks_test", 50);
+    ASSERT_EQ(fromMemory.size(), expected.size());
+    for(std::size_t i = 0; i < expected.size(); ++i){
+        EXPECT_EQ(fromMemory[i], fromFile[i]);
+        EXPECT_EQ(read(fromMemory[i]), expected[i]);
+    }
+    EXPECT_TRUE(FileChunker::split(std::string_view(), "empty.txt", "chunks_test", 50).empty());
+    std::filesystem::remove_all("chunks_test");
+    helper.deleteFile("big.txt");
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "FileTestHelper.hpp"
+#include "HostFactsCache.hpp"
+
+static HostFacts makeFacts(const std::string& source, const std::string& ip = "")
+{
+    HostFacts facts;
+    facts.m_source = source;
+    facts.m_home = "/home/user";
+    facts.m_prompt = "user@host:/home/user >";
+    facts.m_ip = ip;
+    return facts;
+}
+
+TEST(HostFactsCacheTest, StoredFactsAreReadByNewObject)
+{
+    const std::string file = "facts.txt";
+    FileTestHelper helper;
+    const HostData host("alias", "hostname", "", "user", "password", "23", "script.sh");
+    {
+        HostFactsCache cache(file);
+        EXPECT_FALSE(cache.get(host).has_value());
+        cache.store(host, makeFacts("/src/path", "10.0.0.1"));
+    }
+    {
+        HostFactsCache cache(file);
+        const auto& facts = cache.get(host);
+        ASSERT_TRUE(facts.has_value());
+        EXPECT_EQ(facts->m_source, "/src/path");
+        EXPECT_EQ(facts->m_home, "/home/user");
+        EXPECT_EQ(facts->m_prompt, "user@host:/home/user >");
+        EXPECT_EQ(facts->m_ip, "10.0.0.1");
+    }
+    helper.deleteFile(file);
+}
+
+TEST(HostFactsCacheTest, FactsOfChangedHostAreIgnored)
+{
+    const std::string file = "facts.txt";
+    FileTestHelper helper;
+    const HostData host("alias", "hostname", "", "user", "password", "23", "script.sh");
+    HostFactsCache cache(file);
+    cache.store(host, makeFacts("/src/path"));
+
+    HostData otherScript = host;
+    otherScript.m_script = "other.sh";
+    EXPECT_FALSE(cache.get(otherScript).has_value());
+    HostData otherHostname = host;
+    otherHostname.m_hostname = "other";
+    EXPECT_FALSE(cache.get(otherHostname).has_value());
+    HostData otherPassword = host;
+    otherPassword.m_password = "changed";
+    EXPECT_TRUE(cache.get(otherPassword).has_value());
+    helper.deleteFile(file);
+}
+
+TEST(HostFactsCacheTest, ExpiredFactsAreIgnored)
+{
+    const std::string file = "facts.txt";
+    FileTestHelper helper;
+    const HostData host("alias", "hostname", "", "user", "password", "23", "script.sh");
+    HostFactsCache cache(file, std::chrono::hours(0));
+    cache.store(host, makeFacts("/src/path"));
+    EXPECT_FALSE(cache.get(host).has_value());
+    cache.setTtl(std::chrono::hours(1));
+    EXPECT_TRUE(cache.get(host).has_value());
+    helper.deleteFile(file);
+}
+
+TEST(HostFactsCacheTest, EmptyFactsDontOverwriteStoredOnes)
+{
+    const std::string file = "facts.txt";
+    FileTestHelper helper;
+    const HostData host("alias", "hostname", "", "user", "password", "23", "script.sh");
+    HostFactsCache cache(file);
+    cache.store(host, makeFacts("/src/path"));
+    HostFacts address;
+    address.m_ip = "10.0.0.2";
+    cache.store(host, address);
+    const auto& facts = cache.get(host);
+    ASSERT_TRUE(facts.has_value());
+    EXPECT_EQ(facts->m_source, "/src/path");
+    EXPECT_EQ(facts->m_ip, "10.0.0.2");
+
+    cache.invalidate("alias");
+    EXPECT_FALSE(cache.get(host).has_value());
+    helper.deleteFile(file);
+}
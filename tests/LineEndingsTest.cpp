@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include "LineEndings.hpp"
+
+static std::string read(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+static void write(const std::filesystem::path& path, const std::string& content)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+TEST(LineEndingsTest, TextIsConvertedBothWays)
+{
+    EXPECT_EQ(LineEndings::toLf("a\r\nb\r\n\r\nc"), "a\nb\n\nc");
+    EXPECT_EQ(LineEndings::toLf("lone\rcr\r"), "lone\rcr\r");
+    EXPECT_EQ(LineEndings::toCrlf("a\nb\r\nc\n"), "a\r\nb\r\nc\r\n");
+    EXPECT_EQ(LineEndings::toCrlf("\n"), "\r\n");
+}
+
+TEST(LineEndingsTest, FilesAreConvertedAcrossBlocks)
+{
+    // CRLF pair straddles the 1 MiB block boundary
+    const std::string line(1024 * 1024 - 1, 'x');
+    const std::string crlf = line + "\r\nnext\r\n\r";
+    const std::string lf = line + "\nnext\n\r";
+    write("crlf_test.txt", crlf);
+    ASSERT_TRUE(LineEndings::convert("crlf_test.txt", "lf_test.txt", false));
+    EXPECT_TRUE(read("lf_test.txt") == lf);
+    ASSERT_TRUE(LineEndings::convert("crlf_test.txt", "crlf_again_test.txt", true));
+    EXPECT_TRUE(read("crlf_again_test.txt") == crlf);
+    ASSERT_TRUE(LineEndings::convert("lf_test.txt", "crlf_again_test.txt", true));
+    EXPECT_TRUE(read("crlf_again_test.txt") == crlf);
+    EXPECT_TRUE(LineEndings::hasCr("crlf_test.txt"));
+    for(const auto& file : {"crlf_test.txt", "lf_test.txt", "crlf_again_test.txt"}){
+        std::filesystem::remove(file);
+    }
+}
+
+TEST(LineEndingsTest, BinaryIsDetectedByContentOrName)
+{
+    const LineEndings policy("*.pdf, lib*.a");
+    write("text_test.c", "int main(){}\r\n");
+    write("binary_test.o", std::string("\x7f" "ELF\0\0\x01", 7));
+    write("doc_test.pdf", "%PDF-1.4\n");
+    EXPECT_EQ(policy.kind("text_test.c"), FileKind::Text);
+    EXPECT_EQ(policy.kind("binary_test.o"), FileKind::Binary);
+    EXPECT_EQ(policy.kind("doc_test.pdf"), FileKind::Binary);
+    EXPECT_FALSE(LineEndings::hasCr("doc_test.pdf"));
+    for(const auto& file : {"text_test.c", "binary_test.o", "doc_test.pdf"}){
+        std::filesystem::remove(file);
+    }
+
+    EXPECT_TRUE(LineEndings::matches("lib*.a", "libutil.a"));
+    EXPECT_TRUE(LineEndings::matches("*.?pp", "main.cpp"));
+    EXPECT_FALSE(LineEndings::matches("lib*.a", "util.a"));
+    EXPECT_FALSE(LineEndings::matches("*.a", "lib.ab"));
+}
+
+TEST(LineEndingsTest, ContentInMemoryIsConverted)
+{
+    const std::string line(1024 * 1024 - 1, 'x');
+    ASSERT_TRUE(LineEndings::convertContent(line + "\r\nnext\r\n", "lf_test.txt", false));
+    EXPECT_TRUE(read("lf_test.txt") == line + "\nnext\n");
+    const LineEndings policy("*.bin");
+    EXPECT_EQ(policy.kind("a.c", "text"), FileKind::Text);
+    EXPECT_EQ(policy.kind("a.bin", "text"), FileKind::Binary);
+    EXPECT_EQ(policy.kind("a.o", std::string_view("\0ELF", 4)), FileKind::Binary);
+    std::filesystem::remove("lf_test.txt");
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <fstream>
+#include "LocalFileReader.hpp"
+
+static void write(const std::filesystem::path& path, const std::string& content)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+TEST(LocalFileReaderTest, FileIsMappedOnceForAllStages)
+{
+    write("mapped_test.c", "int a;\r\n");
+    LocalFileReader reader;
+    const auto& first = reader.open("mapped_test.c");
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first->view(), "int a;\r\n");
+
+    std::vector<std::thread> stages;
+    for(int i = 0; i < 4; ++i){
+        stages.emplace_back([&reader, &first](){
+            EXPECT_EQ(reader.open("mapped_test.c"), first);
+        });
+    }
+    for(auto& stage : stages){
+        stage.join();
+    }
+    EXPECT_EQ(reader.mappings(), 1);
+    std::filesystem::remove("mapped_test.c");
+}
+
+TEST(LocalFileReaderTest, ChangedFileIsMappedAgain)
+{
+    write("mapped_test.c", "int a;\n");
+    LocalFileReader reader;
+    const auto& before = reader.open("mapped_test.c");
+    write("mapped_test.c", "int ab;\n");
+    const auto& after = reader.open("mapped_test.c");
+    ASSERT_NE(after, nullptr);
+    EXPECT_EQ(after->view(), "int ab;\n");
+    // view handed out earlier is still readable
+    EXPECT_EQ(before->view().size(), 7);
+    reader.clear();
+    EXPECT_EQ(reader.mappings(), 2);
+    std::filesystem::remove("mapped_test.c");
+}
+
+TEST(LocalFileReaderTest, ReleasedFileIsMappedAgain)
+{
+    write("mapped_test.c", "int a;\n");
+    LocalFileReader reader;
+    const auto& first = reader.open("mapped_test.c");
+    reader.release("mapped_test.c");
+    reader.release("other_test.c");
+    EXPECT_NE(reader.open("mapped_test.c"), first);
+    EXPECT_EQ(reader.mappings(), 2);
+    std::filesystem::remove("mapped_test.c");
+}
+
+TEST(LocalFileReaderTest, LargeAndMissingFilesAreStreamed)
+{
+    write("mapped_test.c", std::string(100, 'x'));
+    write("empty_test.c", "");
+    LocalFileReader reader(50);
+    EXPECT_EQ(reader.open("mapped_test.c"), nullptr);
+    EXPECT_EQ(reader.open("missing_test.c"), nullptr);
+    const auto& empty = reader.open("empty_test.c");
+    ASSERT_NE(empty, nullptr);
+    EXPECT_TRUE(empty->view().empty());
+    std::filesystem::remove("mapped_test.c");
+    std::filesystem::remove("empty_test.c");
+}
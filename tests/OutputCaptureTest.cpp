@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include "OutputCapture.hpp"
+
+TEST(OutputCaptureTest, KeepsOnlyTail)
+{
+    OutputCapture capture(8);
+    capture.append("0123456789");
+    EXPECT_EQ(capture.tail(), "23456789");
+    capture.append("abc");
+    EXPECT_EQ(capture.tail(), "56789abc");
+    EXPECT_EQ(capture.totalBytes(), 13);
+}
+
+TEST(OutputCaptureTest, KeepsFirstErrorLines)
+{
+    OutputCapture capture(16, 2);
+    capture.append("ok\r\nfile.c:1: error: x\nwarn");
+    capture.append("ing\nld: fatal\nError again\n");
+    capture.finish();
+    ASSERT_EQ(capture.errorLines().size(), 2);
+    EXPECT_EQ(capture.errorLines()[0], "file.c:1: error: x");
+    EXPECT_EQ(capture.errorLines()[1], "ld: fatal");
+}
+
+TEST(OutputCaptureTest, PassesLinesSplitAcrossChunks)
+{
+    OutputCapture capture(16);
+    std::vector<std::string> lines;
+    capture.setLineCallback([&lines](const std::string& line){ lines.push_back(line); });
+    capture.append("first li");
+    capture.append("ne\nsecond");
+    capture.finish();
+    ASSERT_EQ(lines.size(), 2);
+    EXPECT_EQ(lines[0], "first line");
+    EXPECT_EQ(lines[1], "second");
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
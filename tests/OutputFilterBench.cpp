@@ -0,0 +1,43 @@
+#include <chrono>
+#include <iostream>
+#include "OutputFilter.hpp"
+
+// Measures filtering throughput in MB/s over receive sized chunks of log like text
+static double measure(OutputFilter& filter, const std::string& chunk, const std::size_t& totalBytes)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for(std::size_t done = 0; done < totalBytes; done += chunk.size()){
+        filter.feed(chunk);
+    }
+    filter.finish();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return totalBytes / elapsed.count() / (1024.0 * 1024.0);
+}
+
+int main()
+{
+    const std::size_t total = 256 * 1024 * 1024;
+    std::string chunk;
+    for(int i = 0; chunk.size() < 4096; ++i){
+        chunk += "2024-01-01 12:00:00.000 SERVER_" + std::to_string(i % 7) + " INFO transaction TX" + std::to_string(i) + " processed\n";
+    }
+    chunk += "2024-01-01 12:00:00.000 SERVER_3 ERROR transaction TX42 failed\n";
+
+    std::size_t kept = 0;
+    auto count = [&kept](const char*, const std::size_t& size){ kept += size; };
+
+    OutputFilter keyword(count);
+    keyword.addRule("ERROR");
+    std::cout << "keyword:            " << measure(keyword, chunk, total) << " MB/s" << std::endl;
+
+    OutputFilter context(count);
+    context.addRule("ERROR");
+    context.addRule("!SERVER_5");
+    context.setContext(2, 2);
+    std::cout << "keyword + context:  " << measure(context, chunk, total) << " MB/s" << std::endl;
+
+    OutputFilter regex(count);
+    regex.addRule("/TX4[0-9]+ failed/");
+    std::cout << "regex:              " << measure(regex, chunk, total / 16) << " MB/s" << std::endl;
+    return kept == 0;
+}
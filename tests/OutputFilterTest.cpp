@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "OutputFilter.hpp"
+
+static OutputFilter makeFilter(std::string& out)
+{
+    return OutputFilter([&out](const char* data, const std::size_t& size){ out.append(data, size); });
+}
+
+TEST(OutputFilterTest, FindsLiterals)
+{
+    const std::string text = "0123456789abcdefghijklmnopqrstuvwxyz0123456789 needle end";
+    EXPECT_EQ(OutputFilter::findLiteral(text.data(), text.data() + text.size(), "needle"), text.data() + text.find("needle"));
+    EXPECT_EQ(OutputFilter::findLiteral(text.data(), text.data() + text.size(), "needles"), nullptr);
+    EXPECT_EQ(OutputFilter::findLiteral(text.data(), text.data() + text.size(), "z0"), text.data() + text.find("z0"));
+    EXPECT_EQ(OutputFilter::findLiteral(text.data(), text.data() + text.size(), "d"), text.data() + text.find("d"));
+}
+
+TEST(OutputFilterTest, PassesEverythingWithoutRules)
+{
+    std::string out;
+    auto filter = makeFilter(out);
+    filter.feed("a\nb");
+    EXPECT_EQ(out, "a\nb");
+}
+
+TEST(OutputFilterTest, KeepsMatchingLinesSplitAcrossChunks)
+{
+    std::string out;
+    auto filter = makeFilter(out);
+    EXPECT_TRUE(filter.addRule("ERROR"));
+    filter.feed("ok\nfirst ER");
+    filter.feed("ROR here\nok\nERROR two\nlast ERROR");
+    filter.finish();
+    EXPECT_EQ(out, "first ERROR here\nERROR two\nlast ERROR");
+}
+
+TEST(OutputFilterTest, AppliesExcludeAndRegexRules)
+{
+    std::string out;
+    auto filter = makeFilter(out);
+    EXPECT_TRUE(filter.addRule("/TX[0-9]+/"));
+    EXPECT_TRUE(filter.addRule("!DEBUG"));
+    EXPECT_FALSE(filter.addRule("/[/"));
+    filter.feed("TX12 start\nDEBUG TX13\nTXA\nTX14 end\n");
+    EXPECT_EQ(out, "TX12 start\nTX14 end\n");
+}
+
+TEST(OutputFilterTest, AddsContextLines)
+{
+    std::string out;
+    auto filter = makeFilter(out);
+    filter.addRule("hit");
+    filter.setContext(1, 1);
+    filter.feed("1\n2\n3\nhit\n4\n5\n6\n7\nhit\n8\n");
+    EXPECT_EQ(out, "3\nhit\n4\n7\nhit\n8\n");
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
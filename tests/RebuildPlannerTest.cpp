@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include "FileTestHelper.hpp"
+#include "RebuildPlanner.hpp"
+
+TEST(RebuildPlannerTest, NearestMakefileDirectoryIsBuilt)
+{
+    FileTestHelper helper;
+    helper.createFile("rebuild/Makefile");
+    helper.createFile("rebuild/server/Makefile");
+    helper.createFile("rebuild/lib/core/makefile");
+    helper.createFile("rebuild/server/src/main.c");
+
+    RebuildPlanner planner("rebuild");
+    planner.add("server/src/main.c");
+    planner.add("server/src/util.c");
+    planner.add("lib/core/core.c");
+    planner.add("include/common.h");
+    planner.add("deleted/dir/file.c");
+    EXPECT_EQ(planner.directories(), std::set<std::filesystem::path>({"server", "lib/core", ""}));
+    EXPECT_TRUE(planner.unbuildable().empty());
+
+    const auto& waves = planner.waves();
+    ASSERT_EQ(waves.size(), 3);
+    EXPECT_EQ(waves[0], std::vector<std::filesystem::path>({"lib/core"}));
+    EXPECT_EQ(waves[1], std::vector<std::filesystem::path>({"server"}));
+    EXPECT_EQ(waves[2], std::vector<std::filesystem::path>({""}));
+}
+
+TEST(RebuildPlannerTest, FilesWithoutMakefileAreReported)
+{
+    FileTestHelper helper;
+    helper.createFile("rebuild/a/Makefile");
+    helper.createFile("rebuild/b/Makefile");
+
+    RebuildPlanner planner("rebuild");
+    planner.add("a/x.c");
+    planner.add("b/y.c");
+    planner.add("doc/readme.txt");
+    EXPECT_EQ(planner.unbuildable(), std::vector<std::filesystem::path>({"doc/readme.txt"}));
+    const auto& waves = planner.waves();
+    ASSERT_EQ(waves.size(), 1);
+    EXPECT_EQ(waves[0], std::vector<std::filesystem::path>({"a", "b"}));
+
+    planner.clear();
+    EXPECT_TRUE(planner.empty());
+    EXPECT_TRUE(planner.unbuildable().empty());
+}
+
+TEST(RebuildPlannerTest, RecognisesSubdirectories)
+{
+    EXPECT_TRUE(RebuildPlanner::isBelow("server/src", "server"));
+    EXPECT_TRUE(RebuildPlanner::isBelow("server", ""));
+    EXPECT_FALSE(RebuildPlanner::isBelow("server", "server"));
+    EXPECT_FALSE(RebuildPlanner::isBelow("serverx/src", "server"));
+    EXPECT_FALSE(RebuildPlanner::isBelow("server", "server/src"));
+    EXPECT_FALSE(RebuildPlanner::isBelow("", ""));
+}
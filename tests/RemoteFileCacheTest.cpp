@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include "FileTestHelper.hpp"
+#include "RemoteFileCache.hpp"
+
+static std::string read(const std::string& path)
+{
+    std::ifstream file(path);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+TEST(RemoteFileCacheTest, CachedFileIsCopiedWhileUnchanged)
+{
+    FileTestHelper helper;
+    helper.createFile("downloaded.c", "int main();");
+    const RemoteStat stat{11, "20240101120000"};
+    {
+        RemoteFileCache cache("cache_test");
+        EXPECT_FALSE(cache.copyTo("host", "/src/main.c", stat, "copy.c"));
+        EXPECT_TRUE(cache.put("host", "/src/main.c", stat, "downloaded.c"));
+    }
+    RemoteFileCache cache("cache_test");
+    EXPECT_TRUE(cache.copyTo("host", "/src/main.c", stat, "copy.c"));
+    EXPECT_EQ(read("copy.c"), "int main();");
+    EXPECT_FALSE(cache.copyTo("host", "/src/main.c", {11, "20240101120001"}, "copy.c"));
+    EXPECT_FALSE(cache.copyTo("other", "/src/main.c", stat, "copy.c"));
+    EXPECT_FALSE(cache.put("host", "/src/unknown_time.c", {11, ""}, "downloaded.c"));
+
+    helper.deleteFile("copy.c");
+    std::filesystem::remove_all("cache_test");
+}
+
+TEST(RemoteFileCacheTest, SameContentIsStoredOnce)
+{
+    FileTestHelper helper;
+    helper.createFile("downloaded.c", "same content");
+    RemoteFileCache cache("cache_test");
+    cache.put("host1", "/src/a.c", {12, "1"}, "downloaded.c");
+    cache.put("host2", "/src/a.c", {12, "2"}, "downloaded.c");
+    cache.put("host1", "/src/b.c", {12, "3"}, "downloaded.c");
+    EXPECT_EQ(cache.objects(), 1);
+    EXPECT_EQ(cache.size(), 12);
+    std::filesystem::remove_all("cache_test");
+}
+
+TEST(RemoteFileCacheTest, LeastRecentlyUsedIsEvicted)
+{
+    FileTestHelper helper;
+    helper.createFile("a.c", "aaaaaaaaaa");
+    helper.createFile("b.c", "bbbbbbbbbb");
+    helper.createFile("c.c", "cccccccccc");
+    RemoteFileCache cache("cache_test", 25);
+    cache.put("host", "/src/a.c", {10, "1"}, "a.c");
+    cache.put("host", "/src/b.c", {10, "1"}, "b.c");
+    EXPECT_TRUE(cache.copyTo("host", "/src/a.c", {10, "1"}, "copy.c"));
+    cache.put("host", "/src/c.c", {10, "1"}, "c.c");
+
+    EXPECT_EQ(cache.size(), 20);
+    EXPECT_TRUE(cache.copyTo("host", "/src/a.c", {10, "1"}, "copy.c"));
+    EXPECT_FALSE(cache.copyTo("host", "/src/b.c", {10, "1"}, "copy.c"));
+    EXPECT_TRUE(cache.copyTo("host", "/src/c.c", {10, "1"}, "copy.c"));
+
+    EXPECT_TRUE(cache.enabled());
+    cache.setBudget(0);
+    EXPECT_FALSE(cache.enabled());
+    EXPECT_EQ(cache.size(), 0);
+    helper.deleteFile("copy.c");
+    std::filesystem::remove_all("cache_test");
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <atomic>
+#include <thread>
+#include "RemotePrefetcher.hpp"
+
+static RemotePrefetcher::Fetch writeName(std::atomic<int>& running, std::atomic<int>& maxRunning)
+{
+    return [&running, &maxRunning](const std::filesystem::path& remote, const std::filesystem::path& directory){
+        maxRunning = std::max(maxRunning.load(), ++running);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        --running;
+        if(remote.filename() == "missing.c"){
+            return false;
+        }
+        std::ofstream(directory / remote.filename()) << remote.string();
+        return true;
+    };
+}
+
+TEST(RemotePrefetcherTest, FilesAreDownloadedWithBoundedConcurrency)
+{
+    std::atomic<int> running(0), maxRunning(0), connections(0);
+    std::vector<std::filesystem::path> files;
+    for(int i = 0; i < 10; ++i){
+        files.push_back("/src/dir" + std::to_string(i) + "/same.c");
+    }
+    {
+        RemotePrefetcher prefetcher("prefetch_test", 2);
+        prefetcher.start([&](){
+            ++connections;
+            return writeName(running, maxRunning);
+        }, files);
+        for(const auto& file : files){
+            const auto& local = prefetcher.take(file);
+            ASSERT_TRUE(local.has_value());
+            std::ifstream stream(local.value());
+            std::string content;
+            stream >> content;
+            EXPECT_EQ(content, file.string());
+        }
+        EXPECT_EQ(prefetcher.downloaded(), files.size());
+        EXPECT_FALSE(prefetcher.take("/src/other.c").has_value());
+    }
+    EXPECT_LE(maxRunning, 2);
+    EXPECT_EQ(connections, 2);
+    EXPECT_TRUE(std::filesystem::is_empty("prefetch_test"));
+    std::filesystem::remove_all("prefetch_test");
+}
+
+TEST(RemotePrefetcherTest, FailedAndCancelledFilesAreNotHandedOver)
+{
+    std::atomic<int> running(0), maxRunning(0);
+    RemotePrefetcher prefetcher("prefetch_test", 1);
+    prefetcher.start([&](){
+        return writeName(running, maxRunning);
+    }, {"/src/missing.c", "/src/a.c", "/src/b.c"});
+    EXPECT_FALSE(prefetcher.take("/src/missing.c").has_value());
+    EXPECT_TRUE(prefetcher.take("/src/b.c").has_value());
+    prefetcher.cancel();
+    EXPECT_FALSE(prefetcher.take("/src/a.c").has_value());
+    EXPECT_FALSE(prefetcher.take("/src/b.c").has_value());
+    std::filesystem::remove_all("prefetch_test");
+}
+
+TEST(RemotePrefetcherTest, ThrowingFetchFailsTheFile)
+{
+    RemotePrefetcher prefetcher("prefetch_test", 1);
+    prefetcher.start([](){
+        return [](const std::filesystem::path& remote, const std::filesystem::path& directory){
+            if(remote.filename() == "a.c"){
+                throw std::runtime_error("connection lost");
+            }
+            std::ofstream(directory / remote.filename()) << remote.string();
+            return true;
+        };
+    }, {"/src/a.c", "/src/b.c"});
+    EXPECT_FALSE(prefetcher.take("/src/a.c").has_value());
+    EXPECT_TRUE(prefetcher.take("/src/b.c").has_value());
+    prefetcher.cancel();
+    std::filesystem::remove_all("prefetch_test");
+}
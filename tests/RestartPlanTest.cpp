@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include "RestartPlan.hpp"
+
+TEST(RestartPlanTest, IndependentTargetsStartTogether)
+{
+    RestartPlan plan;
+    ASSERT_TRUE(plan.parse("S-A,,g-B").first);
+    EXPECT_EQ(plan.targets(), std::vector<std::string>({"S-A", "G-B"}));
+    EXPECT_EQ(plan.next(), std::vector<std::string>({"S-A", "G-B"}));
+    EXPECT_TRUE(plan.next().empty());
+    plan.finished("S-A", true);
+    EXPECT_FALSE(plan.done());
+    plan.finished("G-B", true);
+    EXPECT_TRUE(plan.done());
+}
+
+TEST(RestartPlanTest, DependentStartsAfterDependency)
+{
+    RestartPlan plan;
+    ASSERT_TRUE(plan.parse("S-APP:G-DB:S-CACHE,G-DB,S-CACHE").first);
+    EXPECT_EQ(plan.dependencies("S-APP"), std::vector<std::string>({"G-DB", "S-CACHE"}));
+    EXPECT_EQ(plan.next(), std::vector<std::string>({"G-DB", "S-CACHE"}));
+    plan.finished("G-DB", true);
+    EXPECT_TRUE(plan.next().empty());
+    plan.finished("S-CACHE", true);
+    EXPECT_EQ(plan.next(), std::vector<std::string>({"S-APP"}));
+}
+
+TEST(RestartPlanTest, FailureSkipsDependents)
+{
+    RestartPlan plan;
+    ASSERT_TRUE(plan.parse("G-DB,S-APP:G-DB,S-WEB:S-APP,S-OTHER").first);
+    EXPECT_EQ(plan.next(), std::vector<std::string>({"G-DB", "S-OTHER"}));
+    EXPECT_EQ(plan.finished("G-DB", false), std::vector<std::string>({"S-APP", "S-WEB"}));
+    EXPECT_TRUE(plan.next().empty());
+    plan.finished("S-OTHER", true);
+    EXPECT_TRUE(plan.done());
+}
+
+TEST(RestartPlanTest, RejectsInvalidDependencies)
+{
+    RestartPlan plan;
+    EXPECT_FALSE(plan.parse("S-APP:G-DB").first);
+    EXPECT_FALSE(plan.parse("S-A:S-B,S-B:S-A").first);
+    EXPECT_FALSE(plan.parse("S-A,s-A").first);
+    EXPECT_FALSE(plan.parse(",").first);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include "TaskExecutor.hpp"
+
+TEST(TaskExecutorTest, SingleWorkerRunsTasksInSubmissionOrder)
+{
+    TaskExecutor executor(1);
+    std::vector<int> order;
+    std::vector<std::future<void>> tasks;
+    for(int i = 0; i < 100; ++i){
+        tasks.push_back(executor.submit([&order, i](){
+            order.push_back(i);
+        }));
+    }
+    for(auto& task : tasks){
+        task.get();
+    }
+    ASSERT_EQ(order.size(), 100);
+    for(int i = 0; i < 100; ++i){
+        EXPECT_EQ(order[i], i);
+    }
+}
+
+TEST(TaskExecutorTest, FuturesCarryResultsAndExceptions)
+{
+    TaskExecutor executor(2);
+    auto value = executor.submit([](){
+        return std::string("done");
+    });
+    auto failing = executor.submit([]() -> int{
+        throw std::runtime_error("failed");
+    });
+    EXPECT_EQ(value.get(), "done");
+    EXPECT_THROW(failing.get(), std::runtime_error);
+    // worker which ran the failing task keeps working
+    EXPECT_EQ(executor.submit([](){ return 42; }).get(), 42);
+}
+
+TEST(TaskExecutorTest, TasksRunInParallelOnAllWorkers)
+{
+    TaskExecutor executor(0);
+    EXPECT_EQ(executor.threads(), 1);
+
+    TaskExecutor parallel(4);
+    std::atomic<int> running(0), maxRunning(0);
+    std::vector<std::future<void>> tasks;
+    for(int i = 0; i < 8; ++i){
+        tasks.push_back(parallel.submit([&running, &maxRunning](){
+            maxRunning = std::max(maxRunning.load(), ++running);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            --running;
+        }));
+    }
+    for(auto& task : tasks){
+        task.get();
+    }
+    EXPECT_GT(maxRunning, 1);
+    EXPECT_LE(maxRunning, 4);
+}
+
+TEST(TaskExecutorTest, PendingTasksFinishBeforeShutdown)
+{
+    std::atomic<int> done(0);
+    std::vector<std::future<void>> tasks;
+    {
+        TaskExecutor executor(1);
+        for(int i = 0; i < 20; ++i){
+            tasks.push_back(executor.submit([&done](){
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                ++done;
+            }));
+        }
+    }
+    EXPECT_EQ(done, 20);
+    for(auto& task : tasks){
+        EXPECT_EQ(task.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+    }
+}
+
+TEST(TaskExecutorTest, WorkerThreadsAreRecognized)
+{
+    TaskExecutor executor(1);
+    TaskExecutor other(1);
+    EXPECT_FALSE(executor.isWorkerThread());
+    EXPECT_TRUE(executor.submit([&executor](){ return executor.isWorkerThread(); }).get());
+    EXPECT_FALSE(executor.submit([&other](){ return other.isWorkerThread(); }).get());
+}
@@ -0,0 +1,42 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include "TelnetDecoder.hpp"
+
+// Measures decoding throughput in MB/s over receive sized buffers
+static double measure(const std::vector<uint8_t>& pattern, const std::size_t& totalBytes)
+{
+    TelnetDecoder decoder;
+    std::vector<uint8_t> buffer(pattern.size());
+    std::size_t kept = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for(std::size_t done = 0; done < totalBytes; done += pattern.size()){
+        std::memcpy(buffer.data(), pattern.data(), pattern.size());
+        kept += decoder.decode(buffer.data(), buffer.size());
+        decoder.takeReplies();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if(kept == 0){
+        std::cerr << "nothing decoded" << std::endl;
+    }
+    return totalBytes / elapsed.count() / (1024.0 * 1024.0);
+}
+
+int main()
+{
+    const std::size_t total = 512 * 1024 * 1024;
+    std::vector<uint8_t> text(4096);
+    for(std::size_t i = 0; i < text.size(); ++i){
+        text[i] = (i % 80 == 79) ? '\n' : static_cast<uint8_t>('a' + i % 26);
+    }
+    std::vector<uint8_t> commands(text);
+    for(std::size_t i = 0; i + 3 < commands.size(); i += 256){
+        commands[i] = Telnet::IAC;
+        commands[i + 1] = Telnet::WILL;
+        commands[i + 2] = Telnet::OPT_SGA;
+    }
+    std::cout << "plain text:           " << measure(text, total) << " MB/s" << std::endl;
+    std::cout << "command every 256 B:  " << measure(commands, total) << " MB/s" << std::endl;
+    return 0;
+}
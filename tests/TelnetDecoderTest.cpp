@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "TelnetDecoder.hpp"
+
+using namespace Telnet;
+
+static std::string decode(TelnetDecoder& decoder, std::vector<uint8_t> data)
+{
+    auto size = decoder.decode(data.data(), data.size());
+    return std::string(data.begin(), data.begin() + size);
+}
+
+TEST(TelnetDecoderTest, PassesPlainText)
+{
+    TelnetDecoder decoder;
+    EXPECT_EQ(decode(decoder, {'a', 'b', 'c'}), "abc");
+    EXPECT_FALSE(decoder.hasReplies());
+}
+
+TEST(TelnetDecoderTest, UnescapesDoubledIac)
+{
+    TelnetDecoder decoder;
+    EXPECT_EQ(decode(decoder, {'a', IAC, IAC, 'b'}), std::string("a\xff" "b"));
+}
+
+TEST(TelnetDecoderTest, HandlesCommandSplitAcrossReceives)
+{
+    TelnetDecoder decoder;
+    EXPECT_EQ(decode(decoder, {'a', IAC}), "a");
+    EXPECT_EQ(decode(decoder, {WILL}), "");
+    EXPECT_EQ(decode(decoder, {OPT_ECHO, 'b'}), "b");
+    EXPECT_TRUE(decoder.serverEchoes());
+    EXPECT_EQ(decoder.takeReplies(), std::vector<uint8_t>({IAC, DO, OPT_ECHO}));
+}
+
+TEST(TelnetDecoderTest, SkipsSubnegotiation)
+{
+    TelnetDecoder decoder;
+    EXPECT_EQ(decode(decoder, {'x', IAC, SB, 24, 1, IAC}), "x");
+    EXPECT_EQ(decode(decoder, {SE, 'y'}), "y");
+}
+
+TEST(TelnetDecoderTest, RefusesUnsupportedOptions)
+{
+    TelnetDecoder decoder;
+    decode(decoder, {IAC, DO, 24, IAC, WILL, 5});
+    EXPECT_EQ(decoder.takeReplies(), std::vector<uint8_t>({IAC, WONT, 24, IAC, DONT, 5}));
+}
+
+TEST(TelnetDecoderTest, DoesNotAnswerAcknowledgements)
+{
+    TelnetDecoder decoder;
+    decoder.initialRequests();
+    decode(decoder, {IAC, WILL, OPT_SGA});
+    EXPECT_TRUE(decoder.goAheadSuppressed());
+    decode(decoder, {IAC, DO, OPT_NAWS});
+    EXPECT_EQ(decoder.takeReplies(), std::vector<uint8_t>({IAC, SB, OPT_NAWS, 0, 200, 0, 50, IAC, SE}));
+    decode(decoder, {IAC, WILL, OPT_SGA, IAC, DO, OPT_NAWS});
+    EXPECT_FALSE(decoder.hasReplies());
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,98 @@
+#include <chrono>
+#include <thread>
+#include <iostream>
+#include <algorithm>
+#include "TelnetClient.hpp"
+
+// Measures connect-to-ready time (connect, login, initial script sourced) against a local
+// telnet stand-in that answers every prompt immediately, so only the client's own delays count.
+
+// reads one line sent by the client, skipping telnet negotiation
+static bool readLine(sf::TcpSocket& socket, std::string& line)
+{
+    line.clear();
+    unsigned char byte;
+    std::size_t received;
+    while(socket.receive(&byte, 1, received) == sf::Socket::Status::Done){
+        if(byte == 255){
+            unsigned char command[2];
+            socket.receive(command, 1, received);
+            if(command[0] >= 251 && command[0] <= 254){
+                socket.receive(command + 1, 1, received);
+            }
+        } else if(byte == '\n'){
+            if(!line.empty()){
+                return true;
+            }
+        } else if(byte != '\r'){
+            line += static_cast<char>(byte);
+        }
+    }
+    return false;
+}
+
+static void send(sf::TcpSocket& socket, const std::string& text)
+{
+    void(socket.send(text.c_str(), text.size()));
+}
+
+static void serve(sf::TcpListener& listener, const int& sessions)
+{
+    const std::string prompt = "\r\n/home/user >";
+    for(int i = 0; i < sessions; ++i){
+        sf::TcpSocket socket;
+        if(listener.accept(socket) != sf::Socket::Status::Done){
+            return;
+        }
+        std::string line;
+        send(socket, "\xff\xfd\x01\xff\xfb\x03\r\nlogin: ");
+        readLine(socket, line);
+        send(socket, "Password: ");
+        readLine(socket, line);
+        send(socket, "\r\nLast login: today" + prompt);
+        readLine(socket, line);
+        send(socket, "\r\nzrodla: /home/user/src\r" + prompt);
+        while(readLine(socket, line)){
+            send(socket, prompt);
+        }
+    }
+}
+
+int main()
+{
+    const int sessions = 50;
+    sf::TcpListener listener;
+    if(listener.listen(sf::Socket::AnyPort) != sf::Socket::Status::Done){
+        std::cerr << "unable to listen" << std::endl;
+        return 1;
+    }
+    std::thread server(serve, std::ref(listener), sessions);
+
+    std::vector<double> times;
+    for(int i = 0; i < sessions; ++i){
+        const auto start = std::chrono::steady_clock::now();
+        TelnetClient client;
+        if(!client.connect(sf::IpAddress::LocalHost, listener.getLocalPort()) ||
+           !client.login("user", "password", "env.sh") || !client.executeInitialScript("env.sh")){
+            std::cerr << "session " << i << " failed" << std::endl;
+            listener.close();
+            server.join();
+            return 1;
+        }
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        times.push_back(elapsed.count());
+        client.close();
+    }
+    server.join();
+
+    std::sort(times.begin(), times.end());
+    double total = 0;
+    for(const auto& time : times){
+        total += time;
+    }
+    std::cout << "connect-to-ready over " << sessions << " sessions:" << std::endl;
+    std::cout << "  mean:   " << total / times.size() << " ms" << std::endl;
+    std::cout << "  median: " << times[times.size() / 2] << " ms" << std::endl;
+    std::cout << "  max:    " << times.back() << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "TelnetSessionPool.hpp"
+
+// reads one line sent by the client, skipping telnet negotiation
+static bool readLine(sf::TcpSocket& socket, std::string& line)
+{
+    line.clear();
+    unsigned char byte;
+    std::size_t received;
+    while(socket.receive(&byte, 1, received) == sf::Socket::Status::Done){
+        if(byte == 255){
+            unsigned char command[2];
+            socket.receive(command, 1, received);
+            if(command[0] >= 251 && command[0] <= 254){
+                socket.receive(command + 1, 1, received);
+            }
+        } else if(byte == '\n'){
+            if(!line.empty()){
+                return true;
+            }
+        } else if(byte != '\r'){
+            line += static_cast<char>(byte);
+        }
+    }
+    return false;
+}
+
+static void send(sf::TcpSocket& socket, const std::string& text)
+{
+    void(socket.send(text.c_str(), text.size()));
+}
+
+// local telnet stand-in serving every session on its own thread, until the client disconnects
+class TelnetStandIn{
+public:
+    TelnetStandIn() : m_stopping(false), m_connections(0){
+        m_listening = m_listener.listen(sf::Socket::AnyPort) == sf::Socket::Status::Done;
+        m_listener.setBlocking(false);
+        m_accepting = std::thread([this](){
+            while(!m_stopping){
+                auto socket = std::make_unique<sf::TcpSocket>();
+                if(m_listener.accept(*socket) != sf::Socket::Status::Done){
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                    continue;
+                }
+                ++m_connections;
+                socket->setBlocking(true);
+                m_sessions.emplace_back(serve, std::move(socket));
+            }
+        });
+    }
+    ~TelnetStandIn(){
+        m_stopping = true;
+        m_accepting.join();
+        for(auto& session : m_sessions){
+            session.join();
+        }
+    }
+
+    HostData host() const{
+        return HostData("host", "127.0.0.1", "/home/user/src", "user", "password", std::to_string(m_listener.getLocalPort()), "env.sh");
+    }
+    bool isListening() const {return m_listening;}
+    int connections() const {return m_connections;}
+private:
+    static void serve(std::unique_ptr<sf::TcpSocket> socket){
+        const std::string prompt = "\r\n/home/user >";
+        std::string line;
+        send(*socket, "\xff\xfd\x01\xff\xfb\x03\r\nlogin: ");
+        readLine(*socket, line);
+        send(*socket, "Password: ");
+        readLine(*socket, line);
+        send(*socket, "\r\nLast login: today" + prompt);
+        readLine(*socket, line);
+        send(*socket, "\r\nzrodla: /home/user/src\r" + prompt);
+        while(readLine(*socket, line)){
+            send(*socket, prompt);
+        }
+    }
+
+    sf::TcpListener m_listener;
+    bool m_listening;
+    std::atomic<bool> m_stopping;
+    std::atomic<int> m_connections;
+    std::vector<std::thread> m_sessions;
+    std::thread m_accepting;
+};
+
+TEST(TelnetSessionPoolTest, ReleasedSessionIsHandedOutAgain)
+{
+    TelnetStandIn server;
+    ASSERT_TRUE(server.isListening());
+    TelnetSessionPool pool(2);
+    auto first = pool.acquire(server.host());
+    ASSERT_TRUE(first);
+    EXPECT_TRUE(first->isConnected());
+    TelnetClient* client = &*first;
+    first.release();
+    EXPECT_FALSE(first);
+
+    auto second = pool.acquire(server.host());
+    ASSERT_TRUE(second);
+    EXPECT_EQ(&*second, client);
+    EXPECT_EQ(pool.sessions("host"), 1);
+    EXPECT_EQ(server.connections(), 1);
+}
+
+TEST(TelnetSessionPoolTest, SessionsOpenLazilyUpToLimit)
+{
+    TelnetStandIn server;
+    ASSERT_TRUE(server.isListening());
+    TelnetSessionPool pool(2);
+    EXPECT_EQ(pool.sessions("host"), 0);
+    auto first = pool.acquire(server.host());
+    auto second = pool.acquire(server.host());
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    EXPECT_NE(&*first, &*second);
+    EXPECT_EQ(pool.sessions("host"), 2);
+
+    // pool is exhausted, nothing is released in time
+    EXPECT_FALSE(pool.acquire(server.host(), std::chrono::milliseconds(100)));
+
+    // waiting acquire gets the session released meanwhile
+    TelnetClient* client = &*first;
+    std::thread releasing([&first](){
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        first.release();
+    });
+    auto third = pool.acquire(server.host(), std::chrono::seconds(5));
+    releasing.join();
+    ASSERT_TRUE(third);
+    EXPECT_EQ(&*third, client);
+    EXPECT_EQ(server.connections(), 2);
+}
+
+TEST(TelnetSessionPoolTest, IdleSessionsAreReaped)
+{
+    TelnetStandIn server;
+    ASSERT_TRUE(server.isListening());
+    TelnetSessionPool pool(2, std::chrono::seconds(0));
+    auto busy = pool.acquire(server.host());
+    auto idle = pool.acquire(server.host());
+    ASSERT_TRUE(busy);
+    ASSERT_TRUE(idle);
+    idle.release();
+
+    // busy sessions are never reaped
+    pool.reapIdle();
+    EXPECT_EQ(pool.sessions("host"), 1);
+
+    auto reopened = pool.acquire(server.host());
+    ASSERT_TRUE(reopened);
+    EXPECT_EQ(server.connections(), 3);
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include "ThreeWayMerge.hpp"
+
+TEST(ThreeWayMergeTest, DiffFindsLongestCommonLines)
+{
+    using Pairs = std::vector<std::pair<std::size_t, std::size_t>>;
+    EXPECT_EQ(ThreeWayMerge::diff({1, 2, 3, 4}, {1, 3, 4}), Pairs({{0, 0}, {2, 1}, {3, 2}}));
+    EXPECT_EQ(ThreeWayMerge::diff({1, 2, 3, 1, 2, 2, 1}, {3, 2, 1, 2, 1, 3}).size(), 4);
+    EXPECT_EQ(ThreeWayMerge::diff({}, {1, 2}), Pairs());
+    EXPECT_EQ(ThreeWayMerge::diff({5, 1, 6}, {7, 1, 8}), Pairs({{1, 1}}));
+}
+
+TEST(ThreeWayMergeTest, ChangesOfBothSidesAreMerged)
+{
+    const std::string base = "a\nb\nc\nd\ne\n";
+    const std::string local = "a\nB\nc\nd\ne\n";
+    const std::string remote = "a\nb\nc\nd\nE\nf\n";
+    const auto& result = ThreeWayMerge::merge(base, local, remote);
+    EXPECT_TRUE(result.m_clean);
+    EXPECT_EQ(result.m_text, "a\nB\nc\nd\nE\nf\n");
+}
+
+TEST(ThreeWayMergeTest, UnchangedRemoteTakesLocal)
+{
+    const std::string base = "int a;\nint b;\n";
+    const std::string local = "int a;\nint c;\nint b;\n";
+    // downloaded in ASCII mode, so with CRLF
+    const std::string remote = "int a;\r\nint b;\r\n";
+    const auto& result = ThreeWayMerge::merge(base, local, remote);
+    EXPECT_TRUE(result.m_clean);
+    EXPECT_EQ(result.m_text, local);
+}
+
+TEST(ThreeWayMergeTest, SameChangeOnBothSidesIsNotConflict)
+{
+    const auto& result = ThreeWayMerge::merge("a\nb\nc\n", "a\nx\nc\n", "a\nx\nc\n");
+    EXPECT_TRUE(result.m_clean);
+    EXPECT_EQ(result.m_text, "a\nx\nc\n");
+}
+
+TEST(ThreeWayMergeTest, DifferentChangesOfSameLinesConflict)
+{
+    const auto& result = ThreeWayMerge::merge("a\nb\nc\nd\ne\n", "a\nx\nc\nd\nl\n", "a\ny\nc\nd\nr\n");
+    EXPECT_FALSE(result.m_clean);
+    EXPECT_EQ(result.m_conflicts, 2);
+    EXPECT_TRUE(result.m_text.empty());
+}
+
+TEST(ThreeWayMergeTest, DeletionAndInsertionAtEnd)
+{
+    const auto& result = ThreeWayMerge::merge("a\nb\nc", "a\nc", "a\nb\nc\nd\n");
+    EXPECT_TRUE(result.m_clean);
+    EXPECT_EQ(result.m_text, "a\nc\nd\n");
+}
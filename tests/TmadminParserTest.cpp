@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "TmadminParser.hpp"
+
+static void feed(TmadminParser& parser, const std::vector<std::string>& lines)
+{
+    for(const auto& line : lines){
+        parser.parseLine(line);
+    }
+}
+
+static const std::vector<std::string> PSR = {
+    "tmadmin - Copyright (c) 1996-2016 Oracle.",
+    "> Prog Name      Queue Name  Grp Name      ID RqDone Load Done Current Service",
+    "---------      ----------  --------      -- ------ --------- ---------------",
+    "BBL            30002.00000 SITE1          0     12       600 (  IDLE )",
+    "APPSERV        00001.00001 APPGRP         1      3       150 (  IDLE )\r",
+    "APPSERV        00001.00002 APPGRP         2      0         0 GETDATA",
+    "LONGSERVERNA+  00002.00001 DBGRP          1      0         0 (  IDLE )",
+    "> "
+};
+
+TEST(TmadminParserTest, ReadsServerRows)
+{
+    TmadminParser parser;
+    feed(parser, PSR);
+    ASSERT_EQ(parser.servers().size(), 4);
+    EXPECT_EQ(parser.servers()[1].m_program, "APPSERV");
+    EXPECT_EQ(parser.servers()[1].m_group, "APPGRP");
+    EXPECT_EQ(parser.servers()[1].m_id, 1);
+    EXPECT_EQ(parser.servers()[1].m_status, "(  IDLE )");
+    EXPECT_EQ(parser.servers()[2].m_status, "GETDATA");
+}
+
+TEST(TmadminParserTest, TargetIsReadyWhenItsServersRun)
+{
+    TmadminParser parser;
+    feed(parser, PSR);
+    EXPECT_TRUE(parser.isReady("S-APPSERV"));
+    EXPECT_TRUE(parser.isReady("s-APPSERV"));
+    EXPECT_TRUE(parser.isReady("G-APPGRP"));
+    EXPECT_TRUE(parser.isReady("S-LONGSERVERNAME"));
+    EXPECT_TRUE(parser.isReady("env"));
+    EXPECT_FALSE(parser.isReady("S-OTHER"));
+    EXPECT_FALSE(parser.isReady("G-OTHER"));
+}
+
+TEST(TmadminParserTest, DeadServerIsNotReady)
+{
+    TmadminParser parser;
+    feed(parser, {"---------      ----------  --------      -- ------ --------- ---------------",
+                  "APPSERV        00001.00001 APPGRP         1      0         0 (  IDLE )",
+                  "APPSERV        00001.00002 APPGRP         2      0         0 ( DEAD )"});
+    EXPECT_FALSE(parser.isReady("S-APPSERV"));
+    EXPECT_FALSE(parser.isReady("G-APPGRP"));
+
+    parser.reset();
+    EXPECT_TRUE(parser.servers().empty());
+    feed(parser, {"TPEINVAL - no such group", "APPSERV        00001.00001 APPGRP         1      0         0 (  IDLE )"});
+    EXPECT_TRUE(parser.servers().empty());
+}
+
+TEST(TmadminParserTest, PollsGroupOnly)
+{
+    EXPECT_EQ(TmadminParser::pollCommand("G-DB"), "echo 'psr -g DB' | tmadmin -r | tr -d '\\076'");
+    EXPECT_EQ(TmadminParser::pollCommand("S-APP"), "echo psr | tmadmin -r | tr -d '\\076'");
+}
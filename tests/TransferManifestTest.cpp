@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include "FileTestHelper.hpp"
+#include "ThreeWayMerge.hpp"
+#include "TransferManifest.hpp"
+
+TEST(TransferManifestTest, LastPushedContentIsBase)
+{
+    FileTestHelper helper;
+    helper.createFile("pushed.c", "int a;\n");
+    {
+        TransferManifest manifest("manifest_test");
+        EXPECT_FALSE(manifest.base("host", "/src/a.c").has_value());
+        EXPECT_TRUE(manifest.record("host", "/src/a.c", "pushed.c"));
+        EXPECT_TRUE(manifest.record("host", "/src/b.c", "pushed.c"));
+        helper.createFile("pushed.c", "int b;\n");
+        EXPECT_TRUE(manifest.record("host", "/src/b.c", "pushed.c"));
+    }
+    TransferManifest manifest("manifest_test");
+    EXPECT_EQ(manifest.entries(), 2);
+    EXPECT_EQ(manifest.base("host", "/src/a.c"), "int a;\n");
+    EXPECT_EQ(manifest.base("host", "/src/b.c"), "int b;\n");
+    EXPECT_FALSE(manifest.base("other", "/src/a.c").has_value());
+
+    manifest.forget("host", "/src/a.c");
+    EXPECT_FALSE(manifest.base("host", "/src/a.c").has_value());
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator("manifest_test/objects"), std::filesystem::directory_iterator()), 1);
+
+    helper.deleteFile("pushed.c");
+    std::filesystem::remove_all("manifest_test");
+}
+
+TEST(TransferManifestTest, ConsecutivePushesKeepRemoteChanges)
+{
+    FileTestHelper helper;
+    TransferManifest manifest("manifest_test");
+    helper.createFile("local.c", "int a;\nint b;\nint c;\nint d;\nint e;\n");
+    EXPECT_TRUE(manifest.record("host", "/src/a.c", "local.c"));
+
+    // hotfix made on the remote host while the first line is edited locally, the local file is only pushed
+    std::string remote = "int a;\nint b;\nint c;\nint d;\nint hotfix;\n";
+    const std::string edited = "int a1;\nint b;\nint c;\nint d;\nint e;\n";
+    helper.createFile("local.c", edited);
+    auto merged = ThreeWayMerge::merge(manifest.base("host", "/src/a.c").value(), edited, remote);
+    ASSERT_TRUE(merged.m_clean);
+    remote = merged.m_text;
+    EXPECT_TRUE(manifest.record("host", "/src/a.c", "local.c"));
+    EXPECT_EQ(manifest.base("host", "/src/a.c"), edited);
+
+    // remote-only hotfix is the difference between base and remote, so the next push keeps it
+    const std::string next = "int a1;\nint b;\nint c2;\nint d;\nint e;\n";
+    merged = ThreeWayMerge::merge(manifest.base("host", "/src/a.c").value(), next, remote);
+    ASSERT_TRUE(merged.m_clean);
+    EXPECT_EQ(merged.m_text, "int a1;\nint b;\nint c2;\nint d;\nint hotfix;\n");
+
+    helper.deleteFile("local.c");
+    std::filesystem::remove_all("manifest_test");
+}
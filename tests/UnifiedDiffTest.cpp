@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+#include "UnifiedDiff.hpp"
+
+TEST(UnifiedDiffTest, SameLinesGiveEmptyDiff)
+{
+    EXPECT_EQ(UnifiedDiff::render("a\nb\n", "a\r\nb\r\n", "remote", "local"), "");
+}
+
+TEST(UnifiedDiffTest, ChangeIsShownWithContext)
+{
+    const std::string from = "1\n2\n3\n4\n5\n6\n7\n8\n9\n";
+    const std::string to = "1\n2\n3\n4\nfive\n6\n7\n8\n9\n";
+    EXPECT_EQ(UnifiedDiff::render(from, to, "remote/a.c", "local/a.c"),
+              "--- remote/a.c\n+++ local/a.c\n@@ -2,7 +2,7 @@\n 2\n 3\n 4\n-5\n+five\n 6\n 7\n 8\n");
+}
+
+TEST(UnifiedDiffTest, DistantChangesMakeSeparateHunks)
+{
+    std::string from, to;
+    for(int i = 1; i <= 20; ++i){
+        from += std::to_string(i) + "\n";
+        to += (i == 2 ? "" : std::to_string(i) + "\n") + (i == 18 ? "x\n" : "");
+    }
+    EXPECT_EQ(UnifiedDiff::render(from, to, "a", "b", 1),
+              "--- a\n+++ b\n@@ -1,3 +1,2 @@\n 1\n-2\n 3\n@@ -18,2 +17,3 @@\n 18\n+x\n 19\n");
+}
+
+TEST(UnifiedDiffTest, InsertionIntoEmptyText)
+{
+    EXPECT_EQ(UnifiedDiff::render("", "a\n", "a", "b"), "--- a\n+++ b\n@@ -0,0 +1,1 @@\n+a\n");
+}